@@ -0,0 +1,70 @@
+// Benchmarks.cpp
+// Usage: bench [name...]   (runs every benchmark when no name is given)
+#include "Benchmarks.h"
+#include <cstring>
+#include <iostream>
+
+namespace Bench {
+
+    std::string generateSource(size_t bytes) {
+        std::string source;
+        source.reserve(bytes + 256);
+
+        unsigned seed = 12345;
+        auto nextRandom = [&seed]() {
+            seed = seed * 1103515245u + 12345u;
+            return (seed >> 16) & 0x7FFF;
+        };
+
+        for (size_t i = 0; source.size() < bytes; ++i) {
+            std::string name = "variable_" + std::to_string(nextRandom() % 500);
+            switch (nextRandom() % 6) {
+            case 0:
+                source += "number " + name + " = " + std::to_string(nextRandom()) + "." + std::to_string(nextRandom() % 100) + ";\n";
+                break;
+            case 1:
+                source += "word " + name + " = \"some text with \\\"escapes\\\" and spaces in it\";\n";
+                break;
+            case 2:
+                source += "if (" + name + " >= 10 && other_value != 3) {\n        " + name + " = " + name + " * 2 + 1;\n    }\n";
+                break;
+            case 3:
+                source += "// a line comment explaining the next statement in some detail\n";
+                break;
+            case 4:
+                source += "/* a block comment\n   spanning several lines\n   with * stars */\n";
+                break;
+            default:
+                source += "        " + name + "++;\n";
+                break;
+            }
+        }
+
+        return source;
+    }
+
+} // namespace Bench
+
+int main(int argc, char** argv) {
+    struct Entry { const char* name; void (*run)(); };
+    const Entry benchmarks[] = {
+        { "lexer", Bench::runLexerBenchmark },
+        { "parser", Bench::runParserBenchmark },
+        { "printer", Bench::runPrinterBenchmark },
+        { "errors", Bench::runErrorBenchmark },
+        { "parallel", Bench::runParallelBenchmark },
+    };
+
+    for (const auto& benchmark : benchmarks) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || std::strcmp(argv[i], benchmark.name) == 0;
+        }
+        if (selected) {
+            std::cout << "== " << benchmark.name << " ==" << std::endl;
+            benchmark.run();
+        }
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace Bench {
+
+    // Best wall-clock time of 'repeats' runs of f, in seconds
+    template <typename F>
+    double measureSeconds(F&& f, int repeats = 5) {
+        double best = 1e300;
+        for (int i = 0; i < repeats; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            f();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (elapsed.count() < best) {
+                best = elapsed.count();
+            }
+        }
+        return best;
+    }
+
+    inline void printRate(const char* label, size_t bytes, double seconds) {
+        std::printf("  %-28s %10.2f MB/s  (%.3f ms)\n", label, bytes / seconds / (1024.0 * 1024.0), seconds * 1000.0);
+    }
+
+    // Deterministic synthetic program of roughly 'bytes' bytes mixing every
+    // token kind the lexer knows: declarations, expressions, strings,
+    // comments and indentation.
+    std::string generateSource(size_t bytes);
+
+    // Statement-heavy program the parser accepts (declarations, assignments,
+    // if/else and nested blocks)
+    std::string generateStatements(size_t bytes);
+
+    // Individual benchmarks
+    void runLexerBenchmark();
+    void runParserBenchmark();
+    void runPrinterBenchmark();
+    void runErrorBenchmark();
+    void runParallelBenchmark();
+
+} // namespace Bench
\ No newline at end of file
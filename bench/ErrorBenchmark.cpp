@@ -0,0 +1,103 @@
+// ErrorBenchmark.cpp
+// Validating many small inputs, most of them invalid: exceptions vs results.
+#include "Benchmarks.h"
+#include "../src/Tokenizer.h"
+#include "../src/StatementParser.h"
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace Bench {
+
+    namespace {
+
+        // Snippets as a validation service sees them; about one in five is valid
+        std::vector<std::string> generateSnippets(size_t count) {
+            const char* templates[] = {
+                "number x = (a + b) * 2;",      // valid
+                "number x = (a + b * 2;",       // missing ')'
+                "if (x > 0 { y = 1; }",         // missing ')' after condition
+                "word s = \"unterminated;",     // lexical error
+                "x = 1 + ;",                    // missing operand
+                "{ a = 1; b = 2;",              // missing '}'
+                "(a + b)++;",                   // invalid increment target
+                "y = 3.;",                      // invalid float
+                "number = 5;",                  // missing name
+                "if (a) { b = c @ d; }",        // unrecognized character
+            };
+            const size_t templateCount = sizeof(templates) / sizeof(templates[0]);
+
+            std::vector<std::string> snippets;
+            snippets.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                std::string snippet = "v" + std::to_string(i % 89) + " = " + std::to_string(i) + "; ";
+                snippet += templates[(i * 7) % templateCount];
+                if (i % 2 == 0) {
+                    snippet = templates[0] + std::string(" ") + snippet;
+                }
+                snippets.push_back(std::move(snippet));
+            }
+            return snippets;
+        }
+
+    } // namespace
+
+    void runErrorBenchmark() {
+        const auto snippets = generateSnippets(200000);
+        size_t bytes = 0;
+        for (const auto& snippet : snippets) {
+            bytes += snippet.size();
+        }
+
+        size_t invalid = 0;
+        for (const auto& snippet : snippets) {
+            auto tokens = Lexer::tryTokenize(snippet);
+            invalid += !tokens || !Parser::StatementParser(std::move(tokens.value)).tryParseStatements();
+        }
+        std::cout << "Error-heavy corpus (" << snippets.size() << " snippets, "
+            << invalid * 100 / snippets.size() << "% invalid)" << std::endl;
+
+        size_t checksum = 0;
+        double seconds = measureSeconds([&]() {
+            for (const auto& snippet : snippets) {
+                try {
+                    Parser::StatementParser parser(Lexer::tokenize(snippet));
+                    checksum += parser.parseStatements().size();
+                }
+                catch (const std::runtime_error& e) {
+                    checksum += std::char_traits<char>::length(e.what());
+                }
+            }
+        }, 3);
+        printRate("throwing API", bytes, seconds);
+
+        seconds = measureSeconds([&]() {
+            for (const auto& snippet : snippets) {
+                auto tokens = Lexer::tryTokenize(snippet);
+                if (!tokens) {
+                    checksum += static_cast<size_t>(tokens.error.code);
+                    continue;
+                }
+                auto result = Parser::StatementParser(std::move(tokens.value)).tryParseStatements();
+                checksum += result ? result.value.size() : static_cast<size_t>(result.error.code);
+            }
+        }, 3);
+        printRate("result API, codes only", bytes, seconds);
+
+        seconds = measureSeconds([&]() {
+            for (const auto& snippet : snippets) {
+                auto tokens = Lexer::tryTokenize(snippet);
+                if (!tokens) {
+                    checksum += tokens.error.message().size();
+                    continue;
+                }
+                auto result = Parser::StatementParser(std::move(tokens.value)).tryParseStatements();
+                checksum += result ? result.value.size() : result.error.message().size();
+            }
+        }, 3);
+        printRate("result API with messages", bytes, seconds);
+
+        std::cout << "  checksum " << checksum << std::endl;
+    }
+
+} // namespace Bench
\ No newline at end of file
@@ -0,0 +1,78 @@
+// LexerBenchmark.cpp
+// Tokenizer throughput at each scanning level the CPU supports.
+#include "Benchmarks.h"
+#include "../src/Tokenizer.h"
+#include "../src/Scanner.h"
+#include "../src/StreamLexer.h"
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace Bench {
+
+    namespace {
+
+        void measureLevels(const char* title, const std::string& source) {
+            std::vector<Lexer::PackedToken> tokens;
+            tokens.reserve(source.size() / 4);
+
+            std::cout << title << " (" << source.size() / (1024 * 1024) << " MB)" << std::endl;
+
+            Lexer::ScanLevel original = Lexer::scanLevel();
+            for (Lexer::ScanLevel level : { Lexer::ScanLevel::Scalar, Lexer::ScanLevel::SSE2, Lexer::ScanLevel::AVX2 }) {
+                if (Lexer::setScanLevel(level) != level) {
+                    continue; // not supported on this machine
+                }
+
+                double seconds = measureSeconds([&]() {
+                    tokens.clear();
+                    Lexer::tokenizeInto(source, tokens);
+                });
+
+                std::string label = std::string("tokenizeInto (") + Lexer::scanLevelToString(level) + ")";
+                printRate(label.c_str(), source.size(), seconds);
+            }
+            Lexer::setScanLevel(original);
+        }
+
+        // Long runs: deep indentation, long comments and string literals
+        std::string generateLongRunSource(size_t bytes) {
+            std::string source;
+            source.reserve(bytes + 512);
+            while (source.size() < bytes) {
+                source += "/* " + std::string(200, '-') + " */\n";
+                source += std::string(48, ' ') + "word text = \"" + std::string(150, 'x') + "\";\n";
+                source += "// " + std::string(120, '=') + "\n";
+            }
+            return source;
+        }
+
+    } // namespace
+
+    void runLexerBenchmark() {
+        const std::string source = generateSource(32 * 1024 * 1024);
+        measureLevels("Mixed source", source);
+        measureLevels("Long-run source", generateLongRunSource(32 * 1024 * 1024));
+
+        double seconds = measureSeconds([&]() {
+            auto materialized = Lexer::tokenize(source);
+        }, 3);
+        std::cout << "Mixed source" << std::endl;
+        printRate("tokenize (std::string tokens)", source.size(), seconds);
+
+        // Chunked reads: should stay within a small factor of tokenizeInto()
+        seconds = measureSeconds([&]() {
+            size_t offset = 0;
+            Lexer::StreamLexer lexer([&](char* dest, size_t size) {
+                size_t n = std::min(size, source.size() - offset);
+                std::memcpy(dest, source.data() + offset, n);
+                offset += n;
+                return n;
+            });
+            while (lexer.next()) {
+            }
+        }, 3);
+        printRate("StreamLexer (64 KiB chunks)", source.size(), seconds);
+    }
+
+} // namespace Bench
\ No newline at end of file
@@ -0,0 +1,90 @@
+// ParallelBenchmark.cpp
+// Scaling of tokenizeParallel() and parseProgramParallel() with the number of threads.
+#include "Benchmarks.h"
+#include "../src/Tokenizer.h"
+#include "../src/ParallelLexer.h"
+#include "../src/ParallelParser.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Bench {
+
+    namespace {
+
+        // 1, 2, 4, ... threads, up to one per core
+        std::vector<size_t> threadCounts() {
+            size_t cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+            std::vector<size_t> counts;
+            for (size_t threads = 1; threads < cores; threads *= 2) {
+                counts.push_back(threads);
+            }
+            counts.push_back(cores);
+            return counts;
+        }
+
+        std::string threadsLabel(const char* what, size_t threads) {
+            return std::string(what) + ", " + std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+        }
+
+        void measureLexing() {
+            const std::string source = generateSource(32 * 1024 * 1024);
+            std::vector<Lexer::PackedToken> tokens;
+            tokens.reserve(source.size() / 4);
+
+            std::cout << "Mixed source (" << source.size() / (1024 * 1024) << " MB)" << std::endl;
+
+            double sequential = measureSeconds([&]() {
+                tokens.clear();
+                Lexer::tokenizeInto(source, tokens);
+            });
+            printRate("tokenizeInto (sequential)", source.size(), sequential);
+
+            for (size_t threads : threadCounts()) {
+                Util::ThreadPool pool(threads);
+                double seconds = measureSeconds([&]() {
+                    tokens.clear();
+                    Lexer::tokenizeParallel(source, tokens, pool);
+                });
+
+                printRate(threadsLabel("tokenizeParallel", threads).c_str(), source.size(), seconds);
+                std::printf("  %-28s %10.2fx\n", "  speedup", sequential / seconds);
+            }
+        }
+
+    } // namespace
+
+    void runParallelBenchmark() {
+        measureLexing();
+
+        const std::string source = generateStatements(16 * 1024 * 1024);
+        const auto tokens = Lexer::tokenize(source);
+
+        std::cout << "Statement-heavy source (" << source.size() / (1024 * 1024) << " MB, "
+            << tokens.size() << " tokens, " << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+
+        // Results are kept alive until after timing so AST teardown is not measured
+        std::vector<Parser::Program<AST::StatementPtr>> results;
+
+        double sequential = measureSeconds([&]() {
+            Parser::StatementParser parser(tokens);
+            results.push_back(parser.parseProgram());
+        }, 3);
+        printRate("parseProgram (sequential)", source.size(), sequential);
+        results.clear();
+
+        for (size_t threads : threadCounts()) {
+            Util::ThreadPool pool(threads);
+            double seconds = measureSeconds([&]() {
+                results.push_back(Parser::parseProgramParallel(tokens, pool));
+            }, 3);
+            results.clear();
+
+            printRate(threadsLabel("parallel", threads).c_str(), source.size(), seconds);
+            std::printf("  %-28s %10.2fx\n", "  speedup", sequential / seconds);
+        }
+    }
+
+} // namespace Bench
\ No newline at end of file
@@ -0,0 +1,182 @@
+// ParserBenchmark.cpp
+// Statement parsing throughput on a statement-heavy program.
+#include "Benchmarks.h"
+#include "../src/Tokenizer.h"
+#include "../src/TokenSource.h"
+#include "../src/StatementParser.h"
+#include "../src/Document.h"
+#include "../src/ParseCache.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+    std::string generateStatements(size_t bytes) {
+        std::string source;
+        source.reserve(bytes + 256);
+
+        for (size_t i = 0; source.size() < bytes; ++i) {
+            std::string name = "v" + std::to_string(i % 97);
+            switch (i % 5) {
+            case 0:
+                source += "number " + name + " = (a + b) * (c - " + std::to_string(i) + ") / 2;\n";
+                break;
+            case 1:
+                source += name + " = " + name + " + 1;\n";
+                break;
+            case 2:
+                source += "if (" + name + " > 10 and not done) { " + name + " = 0; count++; } else " + name + "--;\n";
+                break;
+            case 3:
+                source += "boolean flag = x >= y || (z != w && q < r);\n";
+                break;
+            default:
+                source += "{ word s = \"text\"; s = s + \"more\"; }\n";
+                break;
+            }
+        }
+
+        return source;
+    }
+
+    void runParserBenchmark() {
+        const std::string source = generateStatements(4 * 1024 * 1024);
+        const auto tokens = Lexer::tokenize(source);
+
+        std::cout << "Statement-heavy source (" << source.size() / (1024 * 1024) << " MB, "
+            << tokens.size() << " tokens)" << std::endl;
+
+        // Results are kept alive until after timing so AST teardown is not measured
+        std::vector<std::vector<AST::StatementPtr>> results;
+
+        double seconds = measureSeconds([&]() {
+            Parser::StatementParser parser(tokens);
+            results.push_back(parser.parseStatements());
+        }, 3);
+        printRate("parse pre-lexed tokens", source.size(), seconds);
+        results.clear();
+
+        // Top-level structure only: block bodies are brace-matched, not parsed
+        Parser::ParseOptions lazy;
+        lazy.lazyBlocks = true;
+        seconds = measureSeconds([&]() {
+            Parser::StatementParser parser(tokens);
+            parser.setOptions(lazy);
+            results.push_back(parser.parseStatements());
+        }, 3);
+        printRate("parse, lazy blocks", source.size(), seconds);
+        results.clear();
+
+        seconds = measureSeconds([&]() {
+            Lexer::StringTokenSource lazy(source);
+            Parser::StatementParser parser(lazy);
+            results.push_back(parser.parseStatements());
+        }, 3);
+        printRate("lex + parse on demand", source.size(), seconds);
+
+        std::cout << "  " << results.back().size() << " top-level statements" << std::endl;
+
+        // Parse and tear down, heap nodes vs one arena released in bulk
+        results.clear();
+        seconds = measureSeconds([&]() {
+            Parser::StatementParser parser(tokens);
+            auto statements = parser.parseStatements();
+        }, 3);
+        printRate("parse + free (heap nodes)", source.size(), seconds);
+
+        AST::Arena arena;
+        seconds = measureSeconds([&]() {
+            {
+                AST::ArenaScope scope(arena);
+                Parser::StatementParser parser(tokens);
+                auto statements = parser.parseStatements();
+            }
+            arena.release();
+        }, 3);
+        printRate("parse + free (arena nodes)", source.size(), seconds);
+
+        AST::FlatTree flat;
+        seconds = measureSeconds([&]() {
+            flat.clear();
+            Parser::FlatStatementParser parser(tokens, AST::FlatBuilder(flat));
+            flat.roots = parser.parseStatements();
+        }, 3);
+        printRate("parse into flat tree", source.size(), seconds);
+        std::cout << "  " << flat.size() << " flat nodes" << std::endl;
+
+        // Constant evaluation: values decoded by the lexer vs re-reading the spelling
+        double sum = 0;
+        seconds = measureSeconds([&]() {
+            for (AST::NodeId id = 0; id < flat.size(); ++id) {
+                if (flat.kinds[id] == AST::NodeKind::Number) {
+                    sum += flat.numbers[flat.first[id]].real;
+                }
+            }
+        }, 3);
+        printRate("sum literals (decoded)", source.size(), seconds);
+
+        seconds = measureSeconds([&]() {
+            for (AST::NodeId id = 0; id < flat.size(); ++id) {
+                if (flat.kinds[id] == AST::NodeKind::Number) {
+                    sum += std::stod(std::string(flat.textOf(flat.text[id])));
+                }
+            }
+        }, 3);
+        printRate("sum literals (from text)", source.size(), seconds);
+        std::cout << "  " << flat.numbers.size() << " literals (checksum " << sum << ")" << std::endl;
+
+        // A keystroke in the middle of the source and its undo: incremental
+        // vs lexing and parsing everything again
+        Parser::Document document(source);
+        size_t line = source.find('\n', source.size() / 2) + 1;
+        double incremental = measureSeconds([&]() {
+            document.edit(line, 0, "x");
+            document.edit(line, 1, "");
+        }) / 2;
+
+        std::string edited = source;
+        double scratch = measureSeconds([&]() {
+            edited.insert(line, 1, 'x');
+            Parser::StatementParser parser(Lexer::tokenize(edited));
+            auto program = parser.parseProgram(); // the edit may break a statement
+            edited.erase(line, 1);
+        }, 3);
+        std::printf("  %-28s %10.3f ms\n", "edit (incremental)", incremental * 1000.0);
+        std::printf("  %-28s %10.3f ms\n", "edit (lex + parse again)", scratch * 1000.0);
+
+        // The same hundred snippets, parsed again and again
+        std::vector<std::string> snippets;
+        for (size_t i = 0; i < 100; ++i) {
+            size_t at = source.find('\n', i * source.size() / 100) + 1;
+            snippets.push_back(source.substr(at, source.find('\n', at) - at));
+        }
+        size_t snippetBytes = 0;
+        for (const auto& snippet : snippets) {
+            snippetBytes += snippet.size();
+        }
+
+        const size_t rounds = 200;
+        seconds = measureSeconds([&]() {
+            for (size_t round = 0; round < rounds; ++round) {
+                for (const auto& snippet : snippets) {
+                    auto parsed = Parser::parseSource(snippet, Parser::ParseMode::Statements);
+                }
+            }
+        }, 3);
+        printRate("snippets (parse each time)", snippetBytes * rounds, seconds);
+
+        Parser::ParseCache cache;
+        seconds = measureSeconds([&]() {
+            for (size_t round = 0; round < rounds; ++round) {
+                for (const auto& snippet : snippets) {
+                    auto parsed = cache.parse(snippet, Parser::ParseMode::Statements);
+                }
+            }
+        }, 3);
+        printRate("snippets (parse cache)", snippetBytes * rounds, seconds);
+        Parser::ParseCacheStats stats = cache.stats();
+        std::cout << "  " << stats.hits << " hits, " << stats.misses << " misses" << std::endl;
+    }
+
+} // namespace Bench
\ No newline at end of file
@@ -0,0 +1,67 @@
+// PrinterBenchmark.cpp
+// AST printing throughput: whole programs and deeply nested expressions.
+#include "Benchmarks.h"
+#include "../src/Tokenizer.h"
+#include "../src/StatementParser.h"
+#include "../src/Printer.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace Bench {
+
+    void runPrinterBenchmark() {
+        const std::string source = generateStatements(4 * 1024 * 1024);
+        Parser::StatementParser parser(Lexer::tokenize(source));
+        const auto statements = parser.parseStatements();
+
+        std::string buffer;
+        double seconds = measureSeconds([&]() {
+            buffer.clear();
+            for (const auto& stmt : statements) {
+                buffer += stmt->toString();
+            }
+        }, 3);
+        printRate("toString() per statement", buffer.size(), seconds);
+
+        seconds = measureSeconds([&]() {
+            buffer.clear();
+            AST::Printer printer(buffer);
+            for (const auto& stmt : statements) {
+                printer.print(*stmt);
+            }
+        }, 3);
+        printRate("Printer, reused buffer", buffer.size(), seconds);
+
+        seconds = measureSeconds([&]() {
+            std::ostringstream stream;
+            AST::Printer printer(stream);
+            for (const auto& stmt : statements) {
+                printer.print(*stmt);
+            }
+        }, 3);
+        printRate("Printer, ostream", buffer.size(), seconds);
+
+        // One deep expression: a + (a + (a + ...))
+        std::string deep;
+        const int depth = 2000;
+        for (int i = 0; i < depth; ++i) {
+            deep += "a + (";
+        }
+        deep += "a";
+        deep += std::string(depth, ')');
+        deep += ";";
+        Parser::ParseOptions deepOptions;
+        deepOptions.explicitStack = true;
+        Parser::StatementParser deepParser(Lexer::tokenize(deep));
+        deepParser.setOptions(deepOptions);
+        const auto deepStatement = deepParser.parse();
+
+        std::string printed;
+        seconds = measureSeconds([&]() {
+            printed = deepStatement->toString();
+        }, 3);
+        printRate("nested depth 2000", printed.size(), seconds);
+    }
+
+} // namespace Bench
\ No newline at end of file
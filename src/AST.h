@@ -1,137 +1,267 @@
 #pragma once
+#include "Arena.h"
+#include "Error.h"
+#include "Literal.h"
+#include "Number.h"
+#include "Symbol.h"
+#include "TokenKind.h"
+#include <atomic>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <string>
 #include <iostream>
 #include <vector>
 
+namespace Lexer {
+    struct Token;
+}
+
 namespace AST {
 
     // Forward declarations
+    class ASTNode;
     class Expression;
     class Statement;
-    using ExpressionPtr = std::unique_ptr<Expression>;
-    using StatementPtr = std::unique_ptr<Statement>;
+
+    // Deletes heap nodes; arena nodes are left for their Arena to release
+    struct NodeDeleter {
+        void operator()(ASTNode* node) const;
+    };
+
+    using ExpressionPtr = std::unique_ptr<Expression, NodeDeleter>;
+    using StatementPtr = std::unique_ptr<Statement, NodeDeleter>;
+
+    // Node text, allocated next to the node (in its arena, or on the heap)
+    using String = std::pmr::string;
+
+    inline String nodeText(std::string_view text) {
+        return String(text.data(), text.size(), nodeResource());
+    }
+
+    // Names are interned: comparing two names is comparing two 32-bit ids,
+    // and the text is looked up only when printing
+    using Symbol = Lexer::Symbol;
+
+    // Number literals carry their value, decoded once by the lexer
+    using NumberValue = Lexer::NumberValue;
+
+    // Operators are stored as the token kind they were spelled with
+    // (e.g. TokenKind::AmpAmp for "&&", TokenKind::KwAnd for "and")
+    using Operator = Lexer::TokenKind;
+
+    // Tag identifying the concrete class of a node
+    enum class NodeKind : std::uint8_t {
+        // Expressions
+        Number,
+        Identifier,
+        Boolean,
+        String,
+        Binary,
+        Unary,
+        PreIncrement,
+        PostIncrement,
+        PostIncrementOperation,
+        // Statements
+        VariableDeclaration,
+        Assignment,
+        ExpressionStatement,
+        Block,
+        If,
+        LazyBlock
+    }; // enum NodeKind
+
+    template <class Node, class... Args>
+    Node* newNode(Args&&... args);
 
     // Base class for all AST nodes
     class ASTNode {
     public:
+        const NodeKind kind;
+
+        explicit ASTNode(NodeKind kind) : kind(kind) {}
         virtual ~ASTNode() = default;
-        virtual std::string toString() const = 0;
+
+        // Source-like text of the tree (see Printer)
+        std::string toString() const;
+
+        // True if the node was allocated in an Arena
+        bool inArena() const { return arenaOwned; }
+
+    private:
+        template <class Node, class... Args>
+        friend Node* newNode(Args&&... args);
+
+        bool arenaOwned = false;
     };
 
+    // Allocate a node in the active Arena, or on the heap when there is none
+    template <class Node, class... Args>
+    Node* newNode(Args&&... args) {
+        Arena* arena = Arena::current();
+        if (!arena) {
+            return new Node(std::forward<Args>(args)...);
+        }
+
+        void* memory = arena->allocate(sizeof(Node), alignof(Node));
+        Node* node = new (memory) Node(std::forward<Args>(args)...);
+        node->arenaOwned = true;
+        return node;
+    }
+
     // Base class for expressions
     class Expression : public ASTNode {
     public:
+        explicit Expression(NodeKind kind) : ASTNode(kind) {}
         virtual ~Expression() = default;
     };
 
     // Base class for statements  
     class Statement : public ASTNode {
     public:
+        explicit Statement(NodeKind kind) : ASTNode(kind) {}
         virtual ~Statement() = default;
     };
 
+    // Checked downcast on the kind tag (no RTTI): nullptr if node is not a Node
+    template <class Node>
+    const Node* nodeAs(const ASTNode& node) {
+        return node.kind == Node::Kind ? static_cast<const Node*>(&node) : nullptr;
+    }
+
+    template <class Node>
+    Node* nodeAs(ASTNode& node) {
+        return node.kind == Node::Kind ? static_cast<Node*>(&node) : nullptr;
+    }
+
     // Literal number (integers and floats)
     class NumberLiteral : public Expression {
     public:
-        std::string value;
+        static constexpr NodeKind Kind = NodeKind::Number;
 
-        explicit NumberLiteral(const std::string& val) : value(val) {}
+        String value;       // spelling, as written in the source
+        NumberValue number; // decoded value
 
-        std::string toString() const override {
-            return value;
+        explicit NumberLiteral(std::string_view val) : Expression(Kind), value(nodeText(val)) {
+            Lexer::decodeNumber(val, number);
         }
+
+        NumberLiteral(std::string_view val, NumberValue num) : Expression(Kind), value(nodeText(val)), number(num) {}
     };
 
     // Variable identifier  
     class Identifier : public Expression {
     public:
-        std::string name;
+        static constexpr NodeKind Kind = NodeKind::Identifier;
 
-        explicit Identifier(const std::string& n) : name(n) {}
+        Symbol name;
 
-        std::string toString() const override {
-            return name;
-        }
+        explicit Identifier(Symbol n) : Expression(Kind), name(n) {}
     };
 
     // Boolean literal
     class BooleanLiteral : public Expression {
     public:
-        bool value;
+        static constexpr NodeKind Kind = NodeKind::Boolean;
 
-        explicit BooleanLiteral(bool val) : value(val) {}
+        bool value;
 
-        std::string toString() const override {
-            return value ? "true" : "false";
-        }
+        explicit BooleanLiteral(bool val) : Expression(Kind), value(val) {}
     };
 
     // String literal
     class StringLiteral : public Expression {
     public:
-        std::string value;
+        static constexpr NodeKind Kind = NodeKind::String;
+
+        std::string_view value;   // spelling with quotes and escapes, as printed
+        std::string_view decoded; // contents with escapes decoded (a slice of value if there are none)
+
+        explicit StringLiteral(std::string_view val) : Expression(Kind), bytes(nodeText(val)) {
+            if (Lexer::hasEscapes(val)) {
+                Lexer::decodeString(val, bytes);
+            }
+            setViews(val.size());
+        }
+
+        // dec: the decoded contents of val (copied only if val has escapes)
+        StringLiteral(std::string_view val, std::string_view dec) : Expression(Kind), bytes(nodeText(val)) {
+            if (Lexer::hasEscapes(val)) {
+                bytes.append(dec);
+            }
+            setViews(val.size());
+        }
+
+        // The views point into bytes
+        StringLiteral(const StringLiteral&) = delete;
+        StringLiteral& operator=(const StringLiteral&) = delete;
 
-        explicit StringLiteral(const std::string& val) : value(val) {}
+    private:
+        // The spelling, then the decoded contents if they differ from its
+        // slice: one allocation next to the node (in its arena, or on the heap)
+        String bytes;
 
-        std::string toString() const override {
-            return value; // includes the quotes
+        void setViews(size_t spelled) {
+            value = std::string_view(bytes).substr(0, spelled);
+            decoded = bytes.size() > spelled ? std::string_view(bytes).substr(spelled) : Lexer::stringSlice(value);
         }
     };
 
     // Binary operation (left operator right)
     class BinaryOperation : public Expression {
     public:
+        static constexpr NodeKind Kind = NodeKind::Binary;
+
         ExpressionPtr left;
-        std::string operator_;
+        Operator operator_;
         ExpressionPtr right;
 
-        BinaryOperation(ExpressionPtr l, const std::string& op, ExpressionPtr r)
-            : left(std::move(l)), operator_(op), right(std::move(r)) {
-        }
-
-        std::string toString() const override {
-            return "(" + left->toString() + " " + operator_ + " " + right->toString() + ")";
+        BinaryOperation(ExpressionPtr l, Operator op, ExpressionPtr r)
+            : Expression(Kind), left(std::move(l)), operator_(op), right(std::move(r)) {
         }
     };
 
     // Unary operation (operator operand)
     class UnaryOperation : public Expression {
     public:
-        std::string operator_;
+        static constexpr NodeKind Kind = NodeKind::Unary;
+
+        Operator operator_;
         ExpressionPtr operand;
 
-        UnaryOperation(const std::string& op, ExpressionPtr expr)
-            : operator_(op), operand(std::move(expr)) {
+        UnaryOperation(Operator op, ExpressionPtr expr)
+            : Expression(Kind), operator_(op), operand(std::move(expr)) {
         }
+    };
+    // Pre-increment/decrement (++x, --x)
+    class PreIncrement : public Expression {
+    public:
+        static constexpr NodeKind Kind = NodeKind::PreIncrement;
 
-        std::string toString() const override {
-            return "(" + operator_ + " " + operand->toString() + ")";
-        }
+        Operator op;
+        Symbol variable;
+        PreIncrement(Operator o, Symbol v) : Expression(Kind), op(o), variable(v) {}
     };
+
     class PostIncrement : public Expression {
     public:
-        std::string operator_;  // "++"  "--"
-        std::string variable;
-        std::string op;
-        PostIncrement(const std::string& v, const std::string& o) : variable(v), op(o) {}
-        std::string toString() const override {
-            return "(" + variable + op + ")";
-        }
+        static constexpr NodeKind Kind = NodeKind::PostIncrement;
+
+        Symbol variable;
+        Operator op;  // "++"  "--"
+        PostIncrement(Symbol v, Operator o) : Expression(Kind), variable(v), op(o) {}
     };
 
     // Post-increment/decrement (x++, x--)
     class PostIncrementOperation : public Expression {
     public:
-        std::string variable;
-        std::string operator_;  // "++"  "--"
+        static constexpr NodeKind Kind = NodeKind::PostIncrementOperation;
 
-        PostIncrementOperation(const std::string& var, const std::string& op)
-            : variable(var), operator_(op) {
-        }
+        Symbol variable;
+        Operator operator_;  // "++"  "--"
 
-        std::string toString() const override {
-            return "(" + variable + operator_ + ")";
+        PostIncrementOperation(Symbol var, Operator op)
+            : Expression(Kind), variable(var), operator_(op) {
         }
     };
 
@@ -140,143 +270,344 @@ namespace AST {
     // Variable declaration: number x = 5;
     class VariableDeclaration : public Statement {
     public:
-        std::string type;      // "number", "word", "boolean"
-        std::string name;      // variable name
-        ExpressionPtr initializer; // optional initial value
+        static constexpr NodeKind Kind = NodeKind::VariableDeclaration;
 
-        VariableDeclaration(const std::string& t, const std::string& n, ExpressionPtr init = nullptr)
-            : type(t), name(n), initializer(std::move(init)) {
-        }
+        String type;      // "number", "word", "boolean"
+        Symbol name;      // variable name
+        ExpressionPtr initializer; // optional initial value
 
-        std::string toString() const override {
-            std::string result = type + " " + name;
-            if (initializer) {
-                result += " = " + initializer->toString();
-            }
-            return result + ";";
+        VariableDeclaration(const std::string& t, Symbol n, ExpressionPtr init = nullptr)
+            : Statement(Kind), type(nodeText(t)), name(n), initializer(std::move(init)) {
         }
     };
 
     // Assignment: x = 5;
     class AssignmentStatement : public Statement {
     public:
-        std::string variable;
+        static constexpr NodeKind Kind = NodeKind::Assignment;
+
+        Symbol variable;
         ExpressionPtr value;
-        Assignment(const std::string& n, ExpressionPtr v)
-            : name(n), value(std::move(v)) {
-        }
-        std::string toString() const override {
-            return name + " = " + value->toString() + ";";
+        AssignmentStatement(Symbol var, ExpressionPtr v)
+            : Statement(Kind), variable(var), value(std::move(v)) {
         }
     };
 
     // Expression statement: x++; or functionCall();
     class ExpressionStatement : public Statement {
     public:
+        static constexpr NodeKind Kind = NodeKind::ExpressionStatement;
+
         ExpressionPtr expression;
 
         explicit ExpressionStatement(ExpressionPtr expr)
-            : expression(std::move(expr)) {
-        }
-
-        std::string toString() const override {
-            return expression->toString() + ";";
+            : Statement(Kind), expression(std::move(expr)) {
         }
     };
 
     // Block: { statement1; statement2; }
     class Block : public Statement {
     public:
-        std::vector<StatementPtr> statements;
+        static constexpr NodeKind Kind = NodeKind::Block;
+
+        std::pmr::vector<StatementPtr> statements;
 
         explicit Block(std::vector<StatementPtr> stmts = {})
-            : statements(std::move(stmts)) {
+            : Statement(Kind), statements(nodeResource()) {
+            statements.reserve(stmts.size());
+            for (auto& stmt : stmts) {
+                statements.push_back(std::move(stmt));
+            }
         }
 
         void addStatement(StatementPtr stmt) {
             statements.push_back(std::move(stmt));
         }
-
-        std::string toString() const override {
-            std::string result = "{\n";
-            for (const auto& stmt : statements) {
-                result += "  " + stmt->toString() + "\n";
-            }
-            result += "}";
-            return result;
-        }
     };
 
     // If statement: if (condition) thenBlock else elseBlock
     class IfStatement : public Statement {
     public:
+        static constexpr NodeKind Kind = NodeKind::If;
+
         ExpressionPtr condition;
         StatementPtr thenStatement;
         StatementPtr elseStatement; // optional
 
         IfStatement(ExpressionPtr cond, StatementPtr thenStmt, StatementPtr elseStmt = nullptr)
-            : condition(std::move(cond)), thenStatement(std::move(thenStmt)), elseStatement(std::move(elseStmt)) {
+            : Statement(Kind), condition(std::move(cond)), thenStatement(std::move(thenStmt)), elseStatement(std::move(elseStmt)) {
         }
+    };
+
+    // Where the body of a lazy block is, and how to parse it
+    struct LazySource {
+        const Lexer::Token* tokens = nullptr; // between the braces
+        size_t count = 0;
+        size_t depth = 0;                     // nesting depth inside the braces
+        size_t maxDepth = 0;                  // Parser::ParseOptions of the parse
+        bool explicitStack = false;
+    }; // struct LazySource
+
+    // Block whose body is parsed on first use (Parser::ParseOptions::lazyBlocks).
+    // The parser only matched its braces and kept the tokens between them,
+    // which must outlive the node. The body is parsed once, by whichever
+    // thread asks first, always on the heap.
+    class LazyBlock : public Statement {
+    public:
+        static constexpr NodeKind Kind = NodeKind::LazyBlock;
+
+        const LazySource source;
 
-        std::string toString() const override {
-            std::string result = "if (" + condition->toString() + ") " + thenStatement->toString();
-            if (elseStatement) {
-                result += " else " + elseStatement->toString();
+        explicit LazyBlock(const LazySource& source) : Statement(Kind), source(source) {}
+
+        // The parsed body (throws Lexer::SyntaxError if it does not parse)
+        const Block& body() const {
+            if (const Block* block = tryBody()) {
+                return *block;
             }
-            return result;
+            throw Lexer::SyntaxError(bodyError);
+        }
+
+        // The same without exceptions: nullptr if the body does not parse, with the reason in error()
+        const Block* tryBody() const; // in StatementParser.cpp
+        const Lexer::Error& error() const {
+            tryBody();
+            return bodyError;
         }
+
+        // True once the body has been parsed (or failed to)
+        bool parsed() const { return done.load(std::memory_order_acquire); }
+
+    private:
+        friend void detachChildren(ASTNode& node, std::vector<ASTNode*>& pending);
+
+        mutable std::once_flag once;
+        mutable std::atomic<bool> done{ false };
+        mutable StatementPtr parsedBody;
+        mutable Lexer::Error bodyError;
     };
 
-    // Helper functions to create AST nodes (existing)
-    inline ExpressionPtr makeNumber(const std::string& value) {
-        return std::make_unique<NumberLiteral>(value);
+    // Move the children of node out of their owners: heap children go to
+    // pending, arena children are left to their arena
+    inline void detachChildren(ASTNode& node, std::vector<ASTNode*>& pending) {
+        auto detach = [&pending](auto& child) {
+            if (child) {
+                ASTNode* raw = child.release();
+                if (!raw->inArena()) {
+                    pending.push_back(raw);
+                }
+            }
+        };
+
+        switch (node.kind) {
+        case NodeKind::Binary:
+            detach(static_cast<BinaryOperation&>(node).left);
+            detach(static_cast<BinaryOperation&>(node).right);
+            break;
+        case NodeKind::Unary:
+            detach(static_cast<UnaryOperation&>(node).operand);
+            break;
+        case NodeKind::VariableDeclaration:
+            detach(static_cast<VariableDeclaration&>(node).initializer);
+            break;
+        case NodeKind::Assignment:
+            detach(static_cast<AssignmentStatement&>(node).value);
+            break;
+        case NodeKind::ExpressionStatement:
+            detach(static_cast<ExpressionStatement&>(node).expression);
+            break;
+        case NodeKind::Block:
+            for (auto& stmt : static_cast<Block&>(node).statements) {
+                detach(stmt);
+            }
+            break;
+        case NodeKind::If:
+            detach(static_cast<IfStatement&>(node).condition);
+            detach(static_cast<IfStatement&>(node).thenStatement);
+            detach(static_cast<IfStatement&>(node).elseStatement);
+            break;
+        case NodeKind::LazyBlock:
+            detach(static_cast<LazyBlock&>(node).parsedBody);
+            break;
+        default:
+            break; // leaves
+        }
+    }
+
+    // Heap trees are torn down with a worklist instead of recursive
+    // destructors, so deleting a deep tree uses constant stack
+    inline void NodeDeleter::operator()(ASTNode* node) const {
+        if (node->inArena()) {
+            return;
+        }
+
+        std::vector<ASTNode*> pending;
+        while (true) {
+            detachChildren(*node, pending);
+            delete node;
+
+            if (pending.empty()) {
+                break;
+            }
+            node = pending.back();
+            pending.pop_back();
+        }
+    }
+
+    // Helper functions to create AST nodes.
+    // Nodes go to the Arena of the active ArenaScope, or to the heap without one.
+    inline ExpressionPtr makeNumber(std::string_view value) {
+        return ExpressionPtr(newNode<NumberLiteral>(value));
+    }
+
+    inline ExpressionPtr makeNumber(std::string_view value, NumberValue number) {
+        return ExpressionPtr(newNode<NumberLiteral>(value, number));
+    }
+
+    inline ExpressionPtr makeIdentifier(Symbol name) {
+        return ExpressionPtr(newNode<Identifier>(name));
     }
 
     inline ExpressionPtr makeIdentifier(const std::string& name) {
-        return std::make_unique<Identifier>(name);
+        return makeIdentifier(Symbol::intern(name));
     }
 
     inline ExpressionPtr makeBoolean(bool value) {
-        return std::make_unique<BooleanLiteral>(value);
+        return ExpressionPtr(newNode<BooleanLiteral>(value));
+    }
+
+    inline ExpressionPtr makeBinary(ExpressionPtr left, Operator op, ExpressionPtr right) {
+        return ExpressionPtr(newNode<BinaryOperation>(std::move(left), op, std::move(right)));
     }
 
-    inline ExpressionPtr makeBinary(ExpressionPtr left, const std::string& op, ExpressionPtr right) {
-        return std::make_unique<BinaryOperation>(std::move(left), op, std::move(right));
+    inline ExpressionPtr makeUnary(Operator op, ExpressionPtr operand) {
+        return ExpressionPtr(newNode<UnaryOperation>(op, std::move(operand)));
     }
 
-    inline ExpressionPtr makeUnary(const std::string& op, ExpressionPtr operand) {
-        return std::make_unique<UnaryOperation>(op, std::move(operand));
+    inline ExpressionPtr makePreIncrement(Operator op, Symbol variable) {
+        return ExpressionPtr(newNode<PreIncrement>(op, variable));
+    }
+
+    inline ExpressionPtr makePreIncrement(Operator op, const std::string& variable) {
+        return makePreIncrement(op, Symbol::intern(variable));
+    }
+
+    inline ExpressionPtr makePostIncrement(Symbol variable, Operator op) {
+        return ExpressionPtr(newNode<PostIncrement>(variable, op));
+    }
+
+    inline ExpressionPtr makePostIncrement(const std::string& variable, Operator op) {
+        return makePostIncrement(Symbol::intern(variable), op);
     }
 
 
-    // --- 7. STATEMENT FACTORIES ---
-    inline StatementPtr makeVariableDeclaration(const std::string& t, const std::string& n, ExpressionPtr i) {
-        return std::make_unique<VariableDeclaration>(t, n, std::move(i));
+    inline ExpressionPtr makeString(std::string_view value) {
+        return ExpressionPtr(newNode<StringLiteral>(value));
     }
 
-    inline ExpressionPtr makeString(const std::string& value) {
-        return std::make_unique<StringLiteral>(value);
+    // decoded: the contents of value with escapes decoded (e.g. Token::decoded())
+    inline ExpressionPtr makeString(std::string_view value, std::string_view decoded) {
+        return ExpressionPtr(newNode<StringLiteral>(value, decoded));
     }
 
     // Helper functions for statements (NEW)
+    inline StatementPtr makeVariableDeclaration(const std::string& type, Symbol name, ExpressionPtr init = nullptr) {
+        return StatementPtr(newNode<VariableDeclaration>(type, name, std::move(init)));
+    }
+
     inline StatementPtr makeVariableDeclaration(const std::string& type, const std::string& name, ExpressionPtr init = nullptr) {
-        return std::make_unique<VariableDeclaration>(type, name, std::move(init));
+        return makeVariableDeclaration(type, Symbol::intern(name), std::move(init));
+    }
+
+    inline StatementPtr makeAssignment(Symbol var, ExpressionPtr value) {
+        return StatementPtr(newNode<AssignmentStatement>(var, std::move(value)));
     }
 
     inline StatementPtr makeAssignment(const std::string& var, ExpressionPtr value) {
-        return std::make_unique<AssignmentStatement>(var, std::move(value));
+        return makeAssignment(Symbol::intern(var), std::move(value));
     }
 
     inline StatementPtr makeExpressionStatement(ExpressionPtr expr) {
-        return std::make_unique<ExpressionStatement>(std::move(expr));
+        return StatementPtr(newNode<ExpressionStatement>(std::move(expr)));
     }
 
     inline StatementPtr makeBlock(std::vector<StatementPtr> statements = {}) {
-        return std::make_unique<Block>(std::move(statements));
+        return StatementPtr(newNode<Block>(std::move(statements)));
     }
 
     inline StatementPtr makeIf(ExpressionPtr condition, StatementPtr thenStmt, StatementPtr elseStmt = nullptr) {
-        return std::make_unique<IfStatement>(std::move(condition), std::move(thenStmt), std::move(elseStmt));
+        return StatementPtr(newNode<IfStatement>(std::move(condition), std::move(thenStmt), std::move(elseStmt)));
+    }
+
+    inline StatementPtr makeLazyBlock(const LazySource& source) {
+        return StatementPtr(newNode<LazyBlock>(source));
     }
 
+
+    // Node builder that makes the parsers produce the class tree (the default)
+    struct TreeBuilder {
+        using Expression = ExpressionPtr;
+        using Statement = StatementPtr;
+
+        static constexpr bool LazyBlocks = true; // can make LazyBlock nodes
+
+        static ExpressionPtr emptyExpression() { return nullptr; }
+        static StatementPtr emptyStatement() { return nullptr; }
+
+        ExpressionPtr number(std::string_view value, NumberValue number) { return makeNumber(value, number); }
+        ExpressionPtr identifier(Symbol name) { return makeIdentifier(name); }
+        ExpressionPtr boolean(bool value) { return makeBoolean(value); }
+        ExpressionPtr string(std::string_view value, std::string_view decoded) { return makeString(value, decoded); }
+
+        ExpressionPtr binary(ExpressionPtr left, Operator op, ExpressionPtr right) {
+            return makeBinary(std::move(left), op, std::move(right));
+        }
+
+        ExpressionPtr unary(Operator op, ExpressionPtr operand) {
+            return makeUnary(op, std::move(operand));
+        }
+
+        ExpressionPtr preIncrement(Operator op, Symbol variable) {
+            return makePreIncrement(op, variable);
+        }
+
+        ExpressionPtr postIncrement(Symbol variable, Operator op) {
+            return makePostIncrement(variable, op);
+        }
+
+        // If expr is a plain identifier, store its name and return true
+        bool identifierName(const ExpressionPtr& expr, Symbol& name) const {
+            auto identifier = nodeAs<Identifier>(*expr);
+            if (!identifier) {
+                return false;
+            }
+            name = identifier->name;
+            return true;
+        }
+
+        StatementPtr variableDeclaration(const std::string& type, Symbol name, ExpressionPtr init) {
+            return makeVariableDeclaration(type, name, std::move(init));
+        }
+
+        StatementPtr assignment(Symbol variable, ExpressionPtr value) {
+            return makeAssignment(variable, std::move(value));
+        }
+
+        StatementPtr expressionStatement(ExpressionPtr expr) {
+            return makeExpressionStatement(std::move(expr));
+        }
+
+        StatementPtr block(std::vector<StatementPtr> statements) {
+            return makeBlock(std::move(statements));
+        }
+
+        StatementPtr ifStatement(ExpressionPtr condition, StatementPtr thenStmt, StatementPtr elseStmt) {
+            return makeIf(std::move(condition), std::move(thenStmt), std::move(elseStmt));
+        }
+
+        StatementPtr lazyBlock(const LazySource& source) {
+            return makeLazyBlock(source);
+        }
+    }; // struct TreeBuilder
+
 } // namespace AST
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+
+namespace AST {
+
+    // Monotonic arena for AST nodes and their text.
+    // Nodes created while an ArenaScope is active are carved out of the arena
+    // and are never destroyed one by one: dropping a node is a no-op, and the
+    // whole parse result goes away at once when the arena is released or
+    // destroyed. Trees built in an arena must not outlive it.
+    class Arena : public std::pmr::memory_resource {
+    public:
+        static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+        explicit Arena(size_t initialBlockSize = DefaultBlockSize)
+            : blocks(initialBlockSize) {
+        }
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // Free every block at once (all nodes allocated from the arena die here)
+        void release() {
+            blocks.release();
+            allocated = 0;
+        }
+
+        // Bytes handed out since construction or the last release()
+        size_t bytesAllocated() const { return allocated; }
+
+        // Arena used by the AST factory helpers on this thread (nullptr = heap)
+        static Arena*& current() {
+            thread_local Arena* arena = nullptr;
+            return arena;
+        }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            allocated += bytes;
+            return blocks.allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {
+            // Monotonic: memory is only reclaimed by release()
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        std::pmr::monotonic_buffer_resource blocks;
+        size_t allocated = 0;
+    }; // class Arena
+
+    // Route AST allocations on this thread to an arena for the scope's lifetime
+    class ArenaScope {
+    public:
+        explicit ArenaScope(Arena& arena) : previous(Arena::current()) {
+            Arena::current() = &arena;
+        }
+
+        ~ArenaScope() {
+            Arena::current() = previous;
+        }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+    private:
+        Arena* previous;
+    }; // class ArenaScope
+
+    // Route AST allocations on this thread to the heap for the scope's
+    // lifetime, for trees that must not depend on the caller's arena
+    class HeapScope {
+    public:
+        HeapScope() : previous(Arena::current()) {
+            Arena::current() = nullptr;
+        }
+
+        ~HeapScope() {
+            Arena::current() = previous;
+        }
+
+        HeapScope(const HeapScope&) = delete;
+        HeapScope& operator=(const HeapScope&) = delete;
+
+    private:
+        Arena* previous;
+    }; // class HeapScope
+
+    // Memory resource for new node text: the active arena, or the heap
+    inline std::pmr::memory_resource* nodeResource() {
+        Arena* arena = Arena::current();
+        return arena ? static_cast<std::pmr::memory_resource*>(arena) : std::pmr::new_delete_resource();
+    }
+
+} // namespace AST
\ No newline at end of file
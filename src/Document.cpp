@@ -0,0 +1,330 @@
+// Document.cpp
+#include "Document.h"
+#include "ParallelParser.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace Parser {
+
+    Document::Document(std::string_view source) {
+        edit(0, 0, source);
+    }
+
+    std::string Document::source() const {
+        std::string source(text_, 0, gapBegin_);
+        source.append(text_, gapEnd_, std::string::npos);
+        return source;
+    }
+
+    // Move the gap to start at 'to'; costs the bytes it passes
+    void Document::moveGap(size_t to) {
+        if (to < gapBegin_) {
+            size_t n = gapBegin_ - to;
+            std::memmove(&text_[gapEnd_ - n], &text_[to], n);
+            gapBegin_ = to;
+            gapEnd_ -= n;
+        }
+        else if (to > gapBegin_) {
+            size_t n = to - gapBegin_;
+            std::memmove(&text_[gapBegin_], &text_[gapEnd_], n);
+            gapBegin_ += n;
+            gapEnd_ += n;
+        }
+    }
+
+    void Document::replaceText(size_t offset, size_t removed, std::string_view inserted) {
+        moveGap(offset);
+        gapEnd_ += removed;
+
+        // Grow the gap in proportion to the text, so growing stays amortized
+        if (gapEnd_ - gapBegin_ < inserted.size()) {
+            size_t gap = inserted.size() + size() / 2 + 64;
+            std::string grown;
+            grown.reserve(text_.size() - (gapEnd_ - gapBegin_) + gap);
+            grown.append(text_, 0, gapBegin_);
+            grown.append(gap, '\0');
+            grown.append(text_, gapEnd_, std::string::npos);
+            text_ = std::move(grown);
+            gapEnd_ = gapBegin_ + gap;
+        }
+        std::copy(inserted.begin(), inserted.end(), text_.begin() + gapBegin_);
+        gapBegin_ += inserted.size();
+    }
+
+    // Move units so that head_ holds those starting before 'offset'; costs
+    // the units it passes. The tail is measured from the end of textSize bytes.
+    void Document::moveUnitGap(size_t offset, size_t textSize) {
+        while (!head_.empty() && head_.back().start >= offset) {
+            head_.back().start = textSize - head_.back().start;
+            tail_.push_back(std::move(head_.back()));
+            head_.pop_back();
+        }
+        while (!tail_.empty() && textSize - tail_.back().start < offset) {
+            tail_.back().start = textSize - tail_.back().start;
+            head_.push_back(std::move(tail_.back()));
+            tail_.pop_back();
+        }
+    }
+
+    std::uint64_t Document::startOf(const Unit& unit, bool inTail) const {
+        return inTail ? size() - unit.start : unit.start;
+    }
+
+    EditStats Document::edit(size_t offset, size_t removed, std::string_view inserted) {
+        size_t oldSize = size();
+        if (offset > oldSize || removed > oldSize - offset) {
+            throw std::out_of_range("Edit outside the document");
+        }
+
+        EditStats stats;
+        size_t oldEnd = offset + removed; // end of the replaced text, before the edit
+        auto shift = [&](std::uint64_t old) { return old - removed + inserted.size(); }; // for old >= oldEnd
+
+        moveUnitGap(offset, oldSize);
+        replaceText(offset, removed, inserted);
+        size_t newSize = size();
+
+        // Offsets are 32-bit in the packed lexer
+        if (newSize > std::numeric_limits<std::uint32_t>::max()) {
+            head_.clear();
+            tail_.clear();
+            lexError_ = Lexer::Error();
+            lexError_.code = Lexer::ErrorCode::InputTooLarge;
+            lexError_.offset = newSize;
+            return stats;
+        }
+
+        // Old tokens around the edit, with absolute offsets from before it.
+        // The statements before the edit that its tokens may belong to are
+        // taken apart; those after it are pulled out of tail_ only as far as
+        // lexing and parsing need to look.
+        struct Pulled {
+            size_t index; // of its first token in 'old', later in 'work'
+            bool whole;   // starts where the new tokens are back in step
+            Unit unit;
+        }; // struct Pulled
+
+        std::vector<Lexer::Token> old;
+        std::vector<Pulled> pulled;
+        auto pull = [&](std::vector<Lexer::Token>& into, size_t textSize) {
+            std::uint64_t start = textSize - tail_.back().start;
+            pulled.push_back({ into.size(), true, std::move(tail_.back()) });
+            tail_.pop_back();
+            for (const Lexer::Token& token : pulled.back().unit.tokens) {
+                into.push_back(token);
+                into.back().offset += start;
+            }
+        };
+
+        // Lexing restarts where the token before the first one reaching the
+        // edit ended, so take apart statements back to one holding such a token
+        std::vector<Unit> taken;
+        while (!head_.empty()) {
+            taken.push_back(std::move(head_.back()));
+            head_.pop_back();
+            if (taken.back().start + taken.back().tokens.front().text().size() < offset) {
+                break;
+            }
+        }
+        for (auto unit = taken.rbegin(); unit != taken.rend(); ++unit) {
+            for (Lexer::Token& token : unit->tokens) {
+                old.push_back(std::move(token));
+                old.back().offset += unit->start;
+            }
+        }
+
+        // Re-lex from the first token that reaches the edit: a token also
+        // depends on the byte just after it
+        auto available = [&](size_t i) {
+            while (i >= old.size() && !tail_.empty()) {
+                pull(old, oldSize);
+            }
+            return i < old.size();
+        };
+        size_t first = 0;
+        while (available(first) && old[first].offset + old[first].text().size() < offset) {
+            first++;
+        }
+        size_t pos = first == 0 ? 0 : old[first - 1].offset + old[first - 1].text().size();
+
+        // Old tokens after the edit are candidates to fall back in step with:
+        // a token starting at the same place lexes the same, as does the rest
+        size_t resync = first;
+        while (available(resync) && old[resync].offset < oldEnd) {
+            resync++;
+        }
+
+        moveGap(pos);
+        std::string_view rest(text_.data() + gapEnd_, text_.size() - gapEnd_); // the text from pos on
+        std::vector<Lexer::Token> lexed;
+        Lexer::Error error;
+        Lexer::PackedToken packed{};
+        size_t at = 0;
+        bool inStep = false;
+        while (Lexer::nextToken(rest, at, packed, error)) {
+            if (packed.type == Lexer::TokenType::Comment) {
+                continue;
+            }
+
+            std::uint64_t tokenOffset = pos + packed.offset;
+            while (available(resync) && shift(old[resync].offset) < tokenOffset) {
+                resync++;
+            }
+            if (available(resync) && shift(old[resync].offset) == tokenOffset) {
+                inStep = true;
+                break;
+            }
+
+            lexed.emplace_back(packed.type, packed.text(rest), packed.kind, tokenOffset);
+        }
+        stats.tokensLexed = lexed.size();
+
+        // Otherwise the old lexical error, if any, lies further on, at the
+        // same distance from the end
+        if (!inStep) {
+            tail_.clear();
+            resync = old.size();
+            lexError_ = std::move(error);
+            if (lexError_) {
+                lexError_.offset = newSize - (pos + lexError_.offset);
+            }
+        }
+
+        // The new token stream around the edit, with offsets from after it
+        std::vector<Lexer::Token> work;
+        work.reserve(first + lexed.size() + (old.size() - resync));
+        std::move(old.begin(), old.begin() + first, std::back_inserter(work));
+        std::move(lexed.begin(), lexed.end(), std::back_inserter(work));
+        size_t damageEnd = work.size();
+        for (size_t i = resync; i < old.size(); ++i) {
+            work.push_back(std::move(old[i]));
+            work.back().offset = shift(work.back().offset);
+        }
+        for (Pulled& unit : pulled) {
+            unit.whole = unit.index >= resync;
+            unit.index = unit.whole ? unit.index - resync + damageEnd : 0;
+        }
+
+        // Re-parse from the statement holding the token before the new ones
+        // (whether it ends there depends on the token that follows it) until
+        // a statement ends where an old one after the damage started
+        size_t begin = 0;
+        size_t reuse = 0;
+        bool reused = false;
+        std::vector<Unit> parsed;
+        while (begin < work.size()) {
+            size_t end = topLevelEnd(work, begin);
+            while (end == work.size() && !tail_.empty()) {
+                pull(work, newSize);
+                end = topLevelEnd(work, begin);
+            }
+            parsed.push_back(parseUnit(work, begin, end));
+            begin = end;
+
+            if (begin < damageEnd) {
+                continue;
+            }
+            while (reuse < pulled.size() && (!pulled[reuse].whole || pulled[reuse].index < begin)) {
+                reuse++;
+            }
+            if (reuse < pulled.size() && pulled[reuse].index == begin) {
+                reused = true;
+                break;
+            }
+        }
+        stats.statementsParsed = parsed.size();
+
+        // Statements after the damage go back unchanged, still measured from the end
+        if (reused) {
+            for (size_t i = pulled.size(); i-- > reuse; ) {
+                tail_.push_back(std::move(pulled[i].unit));
+            }
+        }
+        std::move(parsed.begin(), parsed.end(), std::back_inserter(head_));
+
+        return stats;
+    }
+
+    // Parse tokens[begin, end), taking them over with offsets made relative
+    Document::Unit Document::parseUnit(std::vector<Lexer::Token>& tokens, size_t begin, size_t end) {
+        Unit unit;
+        unit.start = tokens[begin].offset;
+        unit.tokens.assign(std::make_move_iterator(tokens.begin() + begin), std::make_move_iterator(tokens.begin() + end));
+        for (Lexer::Token& token : unit.tokens) {
+            token.offset -= unit.start;
+        }
+
+        Lexer::VectorTokenSource source(unit.tokens.data(), unit.tokens.size());
+        StatementParser parser(source);
+        auto result = parser.tryParseStatements();
+        unit.statements = std::move(result.value);
+        unit.error = std::move(result.error);
+        return unit;
+    }
+
+    std::vector<Lexer::Token> Document::tokens() const {
+        std::vector<Lexer::Token> tokens;
+        auto add = [&](const Unit& unit, bool inTail) {
+            std::uint64_t start = startOf(unit, inTail);
+            for (const Lexer::Token& token : unit.tokens) {
+                tokens.push_back(token);
+                tokens.back().offset += start;
+            }
+        };
+        for (const Unit& unit : head_) {
+            add(unit, false);
+        }
+        for (auto unit = tail_.rbegin(); unit != tail_.rend(); ++unit) {
+            add(*unit, true);
+        }
+        return tokens;
+    }
+
+    Lexer::Error Document::lexError() const {
+        Lexer::Error error = lexError_;
+        if (error) {
+            error.offset = size() - error.offset;
+        }
+        return error;
+    }
+
+    std::vector<const AST::Statement*> Document::statements() const {
+        std::vector<const AST::Statement*> statements;
+        auto add = [&](const Unit& unit) {
+            for (const auto& statement : unit.statements) {
+                statements.push_back(statement.get());
+            }
+        };
+        for (const Unit& unit : head_) {
+            add(unit);
+        }
+        for (auto unit = tail_.rbegin(); unit != tail_.rend(); ++unit) {
+            add(*unit);
+        }
+        return statements;
+    }
+
+    std::vector<Lexer::Error> Document::diagnostics() const {
+        std::vector<Lexer::Error> diagnostics;
+        auto add = [&](const Unit& unit, bool inTail) {
+            if (unit.error) {
+                diagnostics.push_back(unit.error);
+                diagnostics.back().offset += startOf(unit, inTail);
+            }
+        };
+        for (const Unit& unit : head_) {
+            add(unit, false);
+        }
+        for (auto unit = tail_.rbegin(); unit != tail_.rend(); ++unit) {
+            add(*unit, true);
+        }
+        if (Lexer::Error error = lexError()) {
+            diagnostics.push_back(std::move(error));
+        }
+        return diagnostics;
+    }
+
+} // namespace Parser
\ No newline at end of file
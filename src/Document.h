@@ -0,0 +1,85 @@
+#pragma once
+#include "StatementParser.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Parser {
+
+    // Work done by one Document::edit()
+    struct EditStats {
+        size_t tokensLexed = 0;       // tokens lexed again
+        size_t statementsParsed = 0;  // top-level statements parsed again
+    }; // struct EditStats
+
+    // A source buffer kept lexed and parsed across edits, for editors that
+    // re-check the text on every keystroke. An edit re-lexes from the token
+    // it touches until the new tokens fall back in step with the old ones,
+    // and re-parses only the top-level statements those tokens belong to;
+    // every other statement keeps its tree.
+    //
+    // Every top-level statement is parsed on its own, so an error is
+    // reported per statement and the statements around it still parse. On
+    // error-free text the tokens match tokenize() and the statements match
+    // StatementParser::parseStatements().
+    //
+    // The cost of an edit does not grow with the document: the text is a gap
+    // buffer, each statement keeps its tokens with offsets relative to its
+    // first token, and statements after the edit are positioned from the end
+    // of the text, so inserting or removing bytes moves nothing else. Only
+    // the text and statements between this edit and the previous one move.
+    // source(), tokens(), statements() and diagnostics() build their result
+    // from every statement and cost as much as the document.
+    class Document {
+    public:
+        explicit Document(std::string_view source = {});
+
+        // Replace 'removed' bytes at 'offset' with 'inserted' (throws
+        // std::out_of_range if the range is not inside the source)
+        EditStats edit(size_t offset, size_t removed, std::string_view inserted);
+
+        std::string source() const;
+        size_t size() const { return text_.size() - (gapEnd_ - gapBegin_); }
+
+        // Tokens without comments, up to the lexical error if there is one
+        std::vector<Lexer::Token> tokens() const;
+        Lexer::Error lexError() const;
+
+        // Top-level statements that parsed, in source order
+        std::vector<const AST::Statement*> statements() const;
+
+        // Statement errors in source order, then the lexical error
+        std::vector<Lexer::Error> diagnostics() const;
+
+    private:
+        // A top-level statement: its tokens, and its tree or error. Token and
+        // error offsets are relative to the first token.
+        struct Unit {
+            std::uint64_t start = 0; // offset of the first token (see head_ and tail_)
+            std::vector<Lexer::Token> tokens;
+            std::vector<AST::StatementPtr> statements;
+            Lexer::Error error;
+        }; // struct Unit
+
+        void moveGap(size_t to);
+        void replaceText(size_t offset, size_t removed, std::string_view inserted);
+        void moveUnitGap(size_t offset, size_t textSize);
+        std::uint64_t startOf(const Unit& unit, bool inTail) const;
+        static Unit parseUnit(std::vector<Lexer::Token>& tokens, size_t begin, size_t end);
+
+        // Text with the unused bytes text_[gapBegin_, gapEnd_) left where the
+        // last edit was
+        std::string text_;
+        size_t gapBegin_ = 0;
+        size_t gapEnd_ = 0;
+
+        // Statements before the last edit in order, start being the offset;
+        // those after it in reverse order, start being the distance from the
+        // end of the text
+        std::vector<Unit> head_;
+        std::vector<Unit> tail_;
+        Lexer::Error lexError_; // offset is the distance from the end of the text
+    }; // class Document
+
+} // namespace Parser
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+#include "TokenKind.h"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace Lexer {
+
+    // What went wrong, independent of the message text
+    enum class ErrorCode : std::uint8_t {
+        None,
+
+        // Lexer
+        InvalidFloat,          // "12." without fraction digits
+        UnterminatedString,
+        UnterminatedComment,
+        UnrecognizedCharacter,
+        InputTooLarge,         // offsets do not fit in 32 bits
+        NumberOutOfRange,      // integer beyond 64 bits, or decimal beyond a double
+
+        // Parser
+        UnexpectedEnd,         // input ended where an operand was needed
+        UnexpectedToken,       // token cannot start an operand
+        TrailingToken,         // input left after a complete expression or statement
+        Expected,              // a required construct is missing
+        ExpectedToken,         // a required token is missing; reports the token found
+        ExpectedTokenType,     // as ExpectedToken, also reporting the found token's type
+        ExpectedIdentifier,    // '++' or '--' not followed by a variable
+        InvalidIncrementTarget,
+        NestingTooDeep
+    }; // enum ErrorCode
+
+    // A lexing or parsing error. Only the code, position and the pieces of
+    // the message are recorded; the text is put together by message(), so
+    // callers that only need the code never format a string.
+    struct Error {
+        ErrorCode code = ErrorCode::None;
+        std::uint64_t offset = 0;       // byte offset in the source
+        const char* context = nullptr;  // static text: what was expected, or where
+        std::string token;              // offending token text (empty at end of input)
+        std::uint64_t detail = 0;       // ExpectedTokenType: token type, ExpectedIdentifier: operator kind, NestingTooDeep: limit
+        bool atEnd = false;             // the offending position is the end of input
+
+        explicit operator bool() const { return code != ErrorCode::None; }
+
+        std::string message() const;
+    }; // struct Error
+
+    // Thrown by the throwing APIs (tokenize(), parse(), ...); what() is the message
+    class SyntaxError : public std::runtime_error {
+    public:
+        explicit SyntaxError(Error error) : std::runtime_error(error.message()), error_(std::move(error)) {}
+
+        const Error& error() const { return error_; }
+
+    private:
+        Error error_;
+    }; // class SyntaxError
+
+    // Value or error of an exception-free call
+    template <class T>
+    struct Result {
+        T value{};
+        Error error;
+
+        explicit operator bool() const { return !error; }
+    }; // struct Result
+
+    inline std::string Error::message() const {
+        auto got = [this]() {
+            return atEnd ? std::string("end of input") : "'" + token + "'";
+        };
+
+        switch (code) {
+        case ErrorCode::None:                   return "No error";
+        case ErrorCode::InvalidFloat:           return "Invalid float: missing digits after decimal point";
+        case ErrorCode::UnterminatedString:     return "Unterminated string literal";
+        case ErrorCode::UnterminatedComment:    return "Unterminated block comment";
+        case ErrorCode::UnrecognizedCharacter:  return "Unrecognized character: '" + token + "'";
+        case ErrorCode::InputTooLarge:          return "Input too large to tokenize";
+        case ErrorCode::NumberOutOfRange:       return "Number out of range: '" + token + "'";
+        case ErrorCode::UnexpectedEnd:          return "Unexpected end of input";
+        case ErrorCode::UnexpectedToken:        return "Unexpected token: '" + token + "'";
+        case ErrorCode::TrailingToken:          return std::string("Unexpected token after ") + context + ": '" + token + "'";
+        case ErrorCode::Expected:               return context;
+        case ErrorCode::ExpectedToken:          return std::string(context) + ". Got: " + got();
+        case ErrorCode::ExpectedTokenType:
+            return std::string(context) + ". Got: " + got() + (atEnd ? "" : " (type: " + std::to_string(detail) + ")");
+        case ErrorCode::ExpectedIdentifier:
+            return "Expected identifier after " + std::string(tokenKindText(static_cast<TokenKind>(detail)));
+        case ErrorCode::InvalidIncrementTarget: return "Post-increment/decrement can only be applied to variables";
+        case ErrorCode::NestingTooDeep:         return "Nesting too deep (limit is " + std::to_string(detail) + ")";
+        }
+        return "Unknown error";
+    }
+
+} // namespace Lexer
\ No newline at end of file
@@ -3,42 +3,97 @@
 
 namespace Parser {
 
-	// Constructor
-    ExpressionParser::ExpressionParser(const std::vector<Lexer::Token>& tokens)
-        : tokens(tokens), current(0) {
+    namespace {
+
+        // Binary level of every token kind, built once at compile time.
+        // Adding a binary operator is one entry here.
+        struct BinaryLevelTable {
+            BinaryLevel levels[Lexer::TokenKindCount] = {};
+
+            constexpr BinaryLevelTable() {
+                using Lexer::TokenKind;
+                set(TokenKind::KwOr, BinaryLevel::LogicalOr);
+                set(TokenKind::PipePipe, BinaryLevel::LogicalOr);
+                set(TokenKind::KwAnd, BinaryLevel::LogicalAnd);
+                set(TokenKind::AmpAmp, BinaryLevel::LogicalAnd);
+                set(TokenKind::Pipe, BinaryLevel::BitwiseOr);
+                set(TokenKind::Caret, BinaryLevel::BitwiseXor);
+                set(TokenKind::Amp, BinaryLevel::BitwiseAnd);
+                set(TokenKind::EqualEqual, BinaryLevel::Equality);
+                set(TokenKind::BangEqual, BinaryLevel::Equality);
+                set(TokenKind::Greater, BinaryLevel::Comparison);
+                set(TokenKind::GreaterEqual, BinaryLevel::Comparison);
+                set(TokenKind::Less, BinaryLevel::Comparison);
+                set(TokenKind::LessEqual, BinaryLevel::Comparison);
+                set(TokenKind::ShiftLeft, BinaryLevel::Shift);
+                set(TokenKind::ShiftRight, BinaryLevel::Shift);
+                set(TokenKind::Plus, BinaryLevel::Term);
+                set(TokenKind::Minus, BinaryLevel::Term);
+                set(TokenKind::Star, BinaryLevel::Factor);
+                set(TokenKind::Slash, BinaryLevel::Factor);
+                set(TokenKind::Percent, BinaryLevel::Factor);
+            }
+
+            constexpr void set(Lexer::TokenKind kind, BinaryLevel level) {
+                levels[static_cast<size_t>(kind)] = level;
+            }
+        };
+
+        constexpr BinaryLevelTable binaryLevels{};
+
+    } // namespace
+
+    BinaryLevel binaryLevel(Lexer::TokenKind kind) {
+        return binaryLevels.levels[static_cast<size_t>(kind)];
+    }
+
+	// Constructors
+    template <class Builder>
+    BasicExpressionParser<Builder>::BasicExpressionParser(const std::vector<Lexer::Token>& tokens, Builder builder)
+        : ownedSource(std::make_unique<Lexer::VectorTokenSource>(tokens)), source(ownedSource.get()), builder(std::move(builder)) {
+    }
+
+    template <class Builder>
+    BasicExpressionParser<Builder>::BasicExpressionParser(std::vector<Lexer::Token>&& tokens, Builder builder)
+        : ownedTokens(std::move(tokens)),
+          ownedSource(std::make_unique<Lexer::VectorTokenSource>(ownedTokens)), source(ownedSource.get()), builder(std::move(builder)) {
+    }
+
+    template <class Builder>
+    BasicExpressionParser<Builder>::BasicExpressionParser(Lexer::TokenSource& source, Builder builder)
+        : source(&source), builder(std::move(builder)) {
     }
 
 	// Helper methods
 	// Check if we've consumed all tokens
-    bool ExpressionParser::isAtEnd() const {
-        return current >= tokens.size();
+    template <class Builder>
+    bool BasicExpressionParser<Builder>::isAtEnd() const {
+        return source->isAtEnd();
     }
 
-	// Look at the current token without consuming it
-    Lexer::Token ExpressionParser::peek() const {
-        if (isAtEnd()) {
-            return Lexer::Token(Lexer::TokenType::Unknown, "");
-        }
-        return tokens[current];
+	// Look at the current (or a later) token without consuming it
+    template <class Builder>
+    const Lexer::Token& BasicExpressionParser<Builder>::peek(size_t ahead) const {
+        return source->peek(ahead);
     }
 
 	// Look at the last consumed token
-    Lexer::Token ExpressionParser::previous() const {
-        if (current == 0) {
-            return Lexer::Token(Lexer::TokenType::Unknown, "");
-        }
-        return tokens[current - 1];
+    template <class Builder>
+    const Lexer::Token& BasicExpressionParser<Builder>::previous() const {
+        return source->previous();
     }
 
 	// Check if the current token matches a type
-    bool ExpressionParser::check(Lexer::TokenType type) const {
+    template <class Builder>
+    bool BasicExpressionParser<Builder>::check(Lexer::TokenType type) const {
         if (isAtEnd()) return false;
         return peek().type == type;
     }
 
-	// Check and consume if the current token matches a specific value
-    bool ExpressionParser::match(const std::string& value) {
-        if (!isAtEnd() && peek().value == value) {
+	// Check and consume if the current token is of a specific kind
+    template <class Builder>
+    bool BasicExpressionParser<Builder>::match(Lexer::TokenKind kind) {
+        if (peek().kind == kind) {
             advance();
             return true;
         }
@@ -46,213 +101,357 @@ namespace Parser {
     }
 
 	// Consume the current token and return it
-    Lexer::Token ExpressionParser::advance() {
-        if (!isAtEnd()) current++;
+    template <class Builder>
+    const Lexer::Token& BasicExpressionParser<Builder>::advance() {
+        source->advance();
         return previous();
     }
 
-	// Consume a token of a specific type or throw an error
-    Lexer::Token ExpressionParser::consume(Lexer::TokenType type, const std::string& message) {
-		// If the current token matches the expected type, consume and return it
+	// Consume a token of a specific type or fail
+    template <class Builder>
+    bool BasicExpressionParser<Builder>::consume(Lexer::TokenType type, const char* message) {
+		// If the current token matches the expected type, consume it
         if (check(type)) {
-            return advance();
-        }
-
-		// Otherwise, throw an error with a descriptive message
-        std::string error = message + ". Got: ";
-        if (!isAtEnd()) {
-            error += "'" + peek().value + "'";
-        }
-        else {
-            error += "end of input";
+            advance();
+            return true;
         }
-        throw std::runtime_error(error);
-    }
 
-    // Expression ::= LogicalOr
-    AST::ExpressionPtr ExpressionParser::expression() {
-        return logicalOr();
+		// Otherwise, record an error that reports what was found instead
+        fail(Lexer::ErrorCode::ExpectedToken, message);
+        return false;
     }
 
-    // LogicalOr ::= LogicalAnd ( ('or' | '||') LogicalAnd )*
-    AST::ExpressionPtr ExpressionParser::logicalOr() {
-        auto expr = logicalAnd();
-
-        while (match("or") || match("||")) {
-            std::string operator_ = previous().value;
-            auto right = logicalAnd();
-            expr = AST::makeBinary(std::move(expr), operator_, std::move(right));
+	// Record the first error, positioned at the current token. Only the
+	// pieces of the message are kept; Error::message() formats them on demand.
+    template <class Builder>
+    void BasicExpressionParser<Builder>::fail(Lexer::ErrorCode code, const char* context, std::uint64_t detail) {
+        if (failed()) {
+            return;
         }
 
-        return expr;
-    }
-
-    // LogicalAnd ::= Equality ( ('and' | '&&') Equality )*
-    AST::ExpressionPtr ExpressionParser::logicalAnd() {
-        auto expr = equality();
-
-        while (match("and") || match("&&")) {
-            std::string operator_ = previous().value;
-            auto right = equality();
-            expr = AST::makeBinary(std::move(expr), operator_, std::move(right));
+        // Tokens that ran out because the lexer stopped at malformed input
+        // are reported as that lexical error
+        if (isAtEnd() && source->error()) {
+            error = source->error();
+            return;
         }
 
-        return expr;
-    }
-
-    // Equality ::= Comparison ( ('==' | '!=') Comparison )*
-    AST::ExpressionPtr ExpressionParser::equality() {
-        auto expr = comparison();
-
-        while (match("==") || match("!=")) {
-            std::string operator_ = previous().value;
-            auto right = comparison();
-            expr = AST::makeBinary(std::move(expr), operator_, std::move(right));
+        error.code = code;
+        error.context = context;
+        error.detail = detail;
+        error.atEnd = isAtEnd();
+        if (error.atEnd) {
+            error.offset = previous().offset + previous().text().size();
+        }
+        else {
+            error.offset = peek().offset;
+            error.token = peek().text();
         }
-
-        return expr;
     }
 
-    // Comparison ::= Term ( ('>' | '>=' | '<' | '<=') Term )*
-    AST::ExpressionPtr ExpressionParser::comparison() {
-        auto expr = term();
-
-        while (match(">") || match(">=") || match("<") || match("<=")) {
-            std::string operator_ = previous().value;
-            auto right = term();
-            expr = AST::makeBinary(std::move(expr), operator_, std::move(right));
+    // Nesting depth (parentheses, prefix operators, blocks, ifs)
+    template <class Builder>
+    bool BasicExpressionParser<Builder>::enterNesting() {
+        if (depth >= options.depthLimit()) {
+            fail(Lexer::ErrorCode::NestingTooDeep, nullptr, options.depthLimit());
+            return false;
         }
-
-        return expr;
+        ++depth;
+        return true;
     }
 
-    // Term ::= Factor ( ('+' | '-') Factor )*
-    AST::ExpressionPtr ExpressionParser::term() {
-        auto expr = factor();
-
-        while (match("+") || match("-")) {
-            std::string operator_ = previous().value;
-            auto right = factor();
-            expr = AST::makeBinary(std::move(expr), operator_, std::move(right));
+    // Expression ::= Binary(LogicalOr)
+    template <class Builder>
+    auto BasicExpressionParser<Builder>::expression() -> Expression {
+        if (options.explicitStack) {
+            return expressionIterative();
         }
-
-        return expr;
+        return binary(BinaryLevel::LogicalOr);
     }
 
-    // Factor ::= Unary ( ('*' | '/' | '%') Unary )*
-    AST::ExpressionPtr ExpressionParser::factor() {
+    // Binary(min) ::= Unary ( op Binary(level(op) + 1) )*   for ops with level(op) >= min
+    // One call per operand reaches unary(); the loop climbs as long as the next
+    // operator binds at least as tightly as minLevel. Recursing with level + 1
+    // makes every level left-associative.
+    template <class Builder>
+    auto BasicExpressionParser<Builder>::binary(BinaryLevel minLevel) -> Expression {
         auto expr = unary();
 
-        while (match("*") || match("/") || match("%")) {
-            std::string operator_ = previous().value;
-            auto right = unary();
-            expr = AST::makeBinary(std::move(expr), operator_, std::move(right));
+        while (!failed()) {
+            BinaryLevel level = binaryLevel(peek().kind);
+            if (level == BinaryLevel::None || level < minLevel) {
+                break;
+            }
+
+            Lexer::TokenKind operator_ = advance().kind;
+            auto right = binary(static_cast<BinaryLevel>(static_cast<int>(level) + 1));
+            if (failed()) {
+                return builder.emptyExpression();
+            }
+            expr = builder.binary(std::move(expr), operator_, std::move(right));
         }
 
         return expr;
     }
 
-    // Unary ::= ('not' | '!' | '-' | '+' | '++' | '--') Unary | Postfix
-    AST::ExpressionPtr ExpressionParser::unary() {
+    // Unary ::= ('not' | '!' | '-' | '+') Unary | PreIncrement | Postfix
+    template <class Builder>
+    auto BasicExpressionParser<Builder>::unary() -> Expression {
+        switch (peek().kind) {
         // Handle traditional unary operators
-        if (match("not") || match("!") || match("-") || match("+")) {
-            std::string operator_ = previous().value;
+        case Lexer::TokenKind::KwNot:
+        case Lexer::TokenKind::Bang:
+        case Lexer::TokenKind::Minus:
+        case Lexer::TokenKind::Plus: {
+            Nesting nesting(*this);
+            if (!nesting) {
+                return builder.emptyExpression();
+            }
+            Lexer::TokenKind operator_ = advance().kind;
             auto right = unary();
-            return AST::makeUnary(operator_, std::move(right));
+            if (failed()) {
+                return builder.emptyExpression();
+            }
+            return builder.unary(operator_, std::move(right));
         }
 
-        // Handle pre-increment/decrement (++x, --x)
-        if (match("++") || match("--")) {
-            std::string operator_ = previous().value;
-            if (check(Lexer::TokenType::Identifier)) {
-                advance();
-                std::string variable = previous().value;
-                return AST::makePreIncrement(operator_, variable);
-            }
-            else {
-                throw std::runtime_error("Expected identifier after " + operator_);
-            }
+        case Lexer::TokenKind::PlusPlus:
+        case Lexer::TokenKind::MinusMinus:
+            return preIncrement();
+
+        default:
+            return postfix(primary());
         }
+    }
 
-        return postfix();
+    // PreIncrement ::= ('++' | '--') Identifier
+    template <class Builder>
+    auto BasicExpressionParser<Builder>::preIncrement() -> Expression {
+        Lexer::TokenKind operator_ = advance().kind;
+        if (check(Lexer::TokenType::Identifier)) {
+            advance();
+            return builder.preIncrement(operator_, previous().symbol);
+        }
+        else {
+            fail(Lexer::ErrorCode::ExpectedIdentifier, nullptr, static_cast<std::uint64_t>(operator_));
+            return builder.emptyExpression();
+        }
     }
 
     // Postfix ::= Primary ( '++' | '--' )?
-    AST::ExpressionPtr ExpressionParser::postfix() {
-        auto expr = primary();
+    template <class Builder>
+    auto BasicExpressionParser<Builder>::postfix(Expression expr) -> Expression {
+        if (failed()) {
+            return expr;
+        }
 
         // Check for post-increment/decrement (x++, x--)
-        if (match("++") || match("--")) {
-            std::string operator_ = previous().value;
-
+        Lexer::TokenKind operator_ = peek().kind;
+        if (operator_ == Lexer::TokenKind::PlusPlus || operator_ == Lexer::TokenKind::MinusMinus) {
             // Verify that the expression is an identifier
-            if (auto identifier = dynamic_cast<AST::Identifier*>(expr.get())) {
-                std::string variable = identifier->name;
-                // Release the unique_ptr ownership before creating new node
-                expr.release();
-                return AST::makePostIncrement(variable, operator_);
+            Lexer::Symbol variable;
+            if (builder.identifierName(expr, variable)) {
+                advance();
+                return builder.postIncrement(variable, operator_);
             }
             else {
-                throw std::runtime_error("Post-increment/decrement can only be applied to variables");
+                fail(Lexer::ErrorCode::InvalidIncrementTarget); // at the operator
+                return builder.emptyExpression();
             }
         }
 
         return expr;
     }
 
-    // Primary ::= Number | Identifier | Boolean | '(' Expression ')'
-    AST::ExpressionPtr ExpressionParser::primary() {
+    // Primary ::= Literal | '(' Expression ')'
+    template <class Builder>
+    auto BasicExpressionParser<Builder>::primary() -> Expression {
+		// Handle parenthesized expressions
+        if (match(Lexer::TokenKind::LeftParen)) {
+            Nesting nesting(*this);
+            if (!nesting) {
+                return builder.emptyExpression();
+            }
+            auto expr = expression();
+            if (failed()) {
+                return builder.emptyExpression();
+            }
+            if (!match(Lexer::TokenKind::RightParen)) {
+                fail(Lexer::ErrorCode::Expected, "Expected ')' after expression");
+                return builder.emptyExpression();
+            }
+            return expr;
+        }
+
+        return literal();
+    }
+
+    // Literal ::= Number | Identifier | Boolean | String
+    template <class Builder>
+    auto BasicExpressionParser<Builder>::literal() -> Expression {
 		// Handle boolean literals
-        if (match("true")) {
-            return AST::makeBoolean(true);
+        if (match(Lexer::TokenKind::KwTrue)) {
+            return builder.boolean(true);
         }
-        if (match("false")) {
-            return AST::makeBoolean(false);
+        if (match(Lexer::TokenKind::KwFalse)) {
+            return builder.boolean(false);
         }
 
 		// Handle numbers and identifiers
         if (check(Lexer::TokenType::Number)) {
             advance();
-            return AST::makeNumber(previous().value);
+            return builder.number(previous().text(), previous().number);
         }
 
         if (check(Lexer::TokenType::Identifier)) {
             advance();
-            return AST::makeIdentifier(previous().value);
+            return builder.identifier(previous().symbol);
         }
 
         if (check(Lexer::TokenType::String)) {
             advance();
-            return AST::makeString(previous().value);
+            return builder.string(previous().text(), previous().decoded());
         }
 
-		// Handle parenthesized expressions
-        if (match("(")) {
-            auto expr = expression();
-            if (!match(")")) {
-                throw std::runtime_error("Expected ')' after expression");
+        // Better error messages
+        fail(isAtEnd() ? Lexer::ErrorCode::UnexpectedEnd : Lexer::ErrorCode::UnexpectedToken);
+        return builder.emptyExpression();
+    }
+
+    // Same grammar as expression() with the recursion replaced by two heap
+    // stacks (operator-precedence parsing): prefix operators, '(' and pending
+    // binary operators are frames, finished subtrees are operands. Builds the
+    // same tree as the recursive rules, with the same errors.
+    template <class Builder>
+    auto BasicExpressionParser<Builder>::expressionIterative() -> Expression {
+        enum class FrameType : std::uint8_t { Prefix, Paren, Binary };
+        struct Frame {
+            FrameType type;
+            Lexer::TokenKind operator_;
+            BinaryLevel level;
+        };
+
+        std::vector<Frame> frames;
+        std::vector<Expression> operands;
+        DepthRestore restore(*this);
+
+        auto reduceBinary = [&]() {
+            Frame frame = frames.back();
+            frames.pop_back();
+            auto right = std::move(operands.back());
+            operands.pop_back();
+            operands.back() = builder.binary(std::move(operands.back()), frame.operator_, std::move(right));
+        };
+
+        while (true) {
+            // Operand: open prefix operators and parentheses until a leaf is reached
+            switch (peek().kind) {
+            case Lexer::TokenKind::KwNot:
+            case Lexer::TokenKind::Bang:
+            case Lexer::TokenKind::Minus:
+            case Lexer::TokenKind::Plus:
+                if (!enterNesting()) {
+                    return builder.emptyExpression();
+                }
+                frames.push_back({ FrameType::Prefix, advance().kind, BinaryLevel::None });
+                continue;
+
+            case Lexer::TokenKind::LeftParen:
+                if (!enterNesting()) {
+                    return builder.emptyExpression();
+                }
+                advance();
+                frames.push_back({ FrameType::Paren, Lexer::TokenKind::LeftParen, BinaryLevel::None });
+                continue;
+
+            case Lexer::TokenKind::PlusPlus:
+            case Lexer::TokenKind::MinusMinus:
+                operands.push_back(preIncrement());
+                break;
+
+            default:
+                operands.push_back(postfix(literal()));
+                break;
             }
-            return expr;
-        }
 
-        // Better error messages
-        if (isAtEnd()) {
-            throw std::runtime_error("Unexpected end of input");
-        }
-        else {
-            throw std::runtime_error("Unexpected token: '" + peek().value + "'");
+            if (failed()) {
+                return builder.emptyExpression();
+            }
+
+            // After an operand: reduce, close parentheses, or take the next binary operator
+            while (true) {
+                // Prefix operators bind tighter than any binary operator
+                while (!frames.empty() && frames.back().type == FrameType::Prefix) {
+                    operands.back() = builder.unary(frames.back().operator_, std::move(operands.back()));
+                    frames.pop_back();
+                    --depth;
+                }
+
+                BinaryLevel level = binaryLevel(peek().kind);
+                if (level != BinaryLevel::None) {
+                    // Left-associative: finish pending operators that bind at least as tightly
+                    while (!frames.empty() && frames.back().type == FrameType::Binary && frames.back().level >= level) {
+                        reduceBinary();
+                    }
+                    frames.push_back({ FrameType::Binary, advance().kind, level });
+                    break;
+                }
+
+                while (!frames.empty() && frames.back().type == FrameType::Binary) {
+                    reduceBinary();
+                }
+
+                if (frames.empty()) {
+                    return std::move(operands.back());
+                }
+
+                // The innermost '(' must be closed here
+                if (!match(Lexer::TokenKind::RightParen)) {
+                    fail(Lexer::ErrorCode::Expected, "Expected ')' after expression");
+                    return builder.emptyExpression();
+                }
+                frames.pop_back();
+                --depth;
+                operands.back() = postfix(std::move(operands.back()));
+                if (failed()) {
+                    return builder.emptyExpression();
+                }
+            }
         }
     }
 
-    AST::ExpressionPtr ExpressionParser::parse() {
-        auto result = expression();
+    template <class Builder>
+    auto BasicExpressionParser<Builder>::tryParse() -> Lexer::Result<Expression> {
+        Lexer::Result<Expression> result;
+        result.value = expression();
 
         // Check if we consumed all tokens - this catches "2 3" type errors
-        if (!isAtEnd()) {
-            throw std::runtime_error("Unexpected token after expression: '" + peek().value + "'");
+        if (!failed() && !isAtEnd()) {
+            fail(Lexer::ErrorCode::TrailingToken, "expression");
+        }
+
+        // The tokens may have run out at a lexical error
+        if (!failed() && source->error()) {
+            error = source->error();
         }
 
+        if (failed()) {
+            result.value = builder.emptyExpression();
+            result.error = error;
+        }
         return result;
     }
 
+    template <class Builder>
+    auto BasicExpressionParser<Builder>::parse() -> Expression {
+        auto result = tryParse();
+        if (!result) {
+            throw Lexer::SyntaxError(std::move(result.error));
+        }
+        return std::move(result.value);
+    }
+
+    template class BasicExpressionParser<AST::TreeBuilder>;
+    template class BasicExpressionParser<AST::FlatBuilder>;
+
 } // namespace Parser
\ No newline at end of file
@@ -1,40 +1,137 @@
 #pragma once
 #include "Tokenizer.h"
+#include "TokenSource.h"
 #include "AST.h"
+#include "FlatAST.h"
+#include <limits>
+#include <memory>
 #include <vector>
 #include <stdexcept>
 
 namespace Parser {
 
-    class ExpressionParser {
+    // Binary operator precedence levels (binding power), loosest first.
+    // All binary operators are left-associative.
+    enum class BinaryLevel : std::uint8_t {
+        None,       // not a binary operator
+        LogicalOr,  // or ||
+        LogicalAnd, // and &&
+        BitwiseOr,  // |
+        BitwiseXor, // ^
+        BitwiseAnd, // &
+        Equality,   // == !=
+        Comparison, // > >= < <=
+        Shift,      // << >>
+        Term,       // + -
+        Factor      // * / %
+    }; // enum BinaryLevel
+
+    // Level of a token kind when used as a binary operator (one table load)
+    BinaryLevel binaryLevel(Lexer::TokenKind kind);
+
+    struct ParseOptions {
+        static constexpr size_t DefaultMaxDepth = 256;
+        static constexpr size_t NoDepthLimit = std::numeric_limits<size_t>::max();
+
+        // Parse with heap-allocated stacks instead of C++ recursion, so the
+        // nesting depth is bounded only by maxDepth and memory
+        bool explicitStack = false;
+
+        // Deepest nesting of parentheses, prefix operators, blocks and ifs;
+        // deeper input fails with an error instead of exhausting the stack.
+        // 0 picks the default for the mode: DefaultMaxDepth when recursing,
+        // no limit with explicitStack (nesting then costs heap, not stack).
+        size_t maxDepth = 0;
+
+        // Only match the braces of blocks and keep their tokens, parsing each
+        // body on first use (AST::LazyBlock). Errors inside a body surface
+        // then. Needs tokens in a vector that outlives the tree; blocks are
+        // parsed in place for lazy token sources, parsers that own their
+        // tokens, under an ArenaScope, by parseProgram() and
+        // parseProgramParallel(), and for flat trees.
+        bool lazyBlocks = false;
+
+        // maxDepth, with 0 resolved for the mode
+        size_t depthLimit() const {
+            if (maxDepth != 0) {
+                return maxDepth;
+            }
+            return explicitStack ? NoDepthLimit : DefaultMaxDepth;
+        }
+    }; // struct ParseOptions
+
+    // Recursive-descent expression parser. Nodes are created through Builder:
+    // AST::TreeBuilder produces the class tree, AST::FlatBuilder a FlatTree.
+    template <class Builder>
+    class BasicExpressionParser {
     protected:
-        std::vector<Lexer::Token> tokens;
-        size_t current;
+        using Expression = typename Builder::Expression;
+
+        std::vector<Lexer::Token> ownedTokens; // only used when constructed from an rvalue vector
+        std::unique_ptr<Lexer::TokenSource> ownedSource;
+        Lexer::TokenSource* source;
+        Builder builder;
+        ParseOptions options;
+        size_t depth = 0; // current nesting depth
+
+        // First error. Rules do not throw: they record the error, return an
+        // empty node, and every caller stops as soon as failed() is set.
+        Lexer::Error error;
+
+        // Counts one nesting level for the lifetime of a recursive rule;
+        // false when the limit is hit (the error is already recorded)
+        struct Nesting {
+            BasicExpressionParser& parser;
+            bool entered;
+            explicit Nesting(BasicExpressionParser& parser) : parser(parser), entered(parser.enterNesting()) {}
+            ~Nesting() { if (entered) --parser.depth; }
+            explicit operator bool() const { return entered; }
+        };
+
+        // Restores the depth when an explicit-stack rule returns or throws
+        struct DepthRestore {
+            BasicExpressionParser& parser;
+            size_t saved;
+            explicit DepthRestore(BasicExpressionParser& parser) : parser(parser), saved(parser.depth) {}
+            ~DepthRestore() { parser.depth = saved; }
+        };
+
+        bool enterNesting(); // fails past options.depthLimit()
+
+        // Error handling
+        bool failed() const { return static_cast<bool>(error); }
+        void fail(Lexer::ErrorCode code, const char* context = nullptr, std::uint64_t detail = 0); // record an error at the current token
 
         // Helper methods
 		bool isAtEnd() const; // Check if we've consumed all tokens
-		Lexer::Token peek() const; // Look at the current token without consuming it
-		Lexer::Token previous() const; // Look at the last consumed token
+		const Lexer::Token& peek(size_t ahead = 0) const; // Look at the current (or a later) token without consuming it
+		const Lexer::Token& previous() const; // Look at the last consumed token
 		bool check(Lexer::TokenType type) const; // Check if the current token matches a type
-		bool match(const std::string& value); // Check and consume if the current token matches a specific value
-		Lexer::Token advance(); // Consume the current token and return it
-		Lexer::Token consume(Lexer::TokenType type, const std::string& message); // Consume a token of a specific type or throw an error
+		bool match(Lexer::TokenKind kind); // Check and consume if the current token is of a specific kind
+		const Lexer::Token& advance(); // Consume the current token and return it
+		bool consume(Lexer::TokenType type, const char* message); // Consume a token of a specific type or fail
 
         // Grammar rules (with increment/decrement support)
-		AST::ExpressionPtr expression(); // Entry point
-		AST::ExpressionPtr logicalOr(); // New method for logical OR
-		AST::ExpressionPtr logicalAnd(); // New method for logical AND
-		AST::ExpressionPtr equality(); // Updated to handle == and !=
-		AST::ExpressionPtr comparison(); // Updated to handle >, >=, <, <=
-		AST::ExpressionPtr term(); // Updated to handle + and -
-		AST::ExpressionPtr factor(); // Updated to handle *, /, and %
-		AST::ExpressionPtr unary(); // Updated to handle unary +, -, not, !, ++, --
-		AST::ExpressionPtr postfix(); // New method for post-increment/decrement
-		AST::ExpressionPtr primary(); // Updated to handle booleans
+		Expression expression(); // Entry point
+		Expression binary(BinaryLevel minLevel); // Precedence climbing over the binaryLevel table
+		Expression unary(); // Updated to handle unary +, -, not, !, ++, --
+		Expression preIncrement(); // ++x, --x
+		Expression postfix(Expression expr); // Apply a trailing ++ or -- to a parsed operand
+		Expression primary(); // Literal or parenthesized expression
+		Expression literal(); // Number, identifier, boolean or string
+		Expression expressionIterative(); // expression() on explicit stacks
 
     public:
-        explicit ExpressionParser(const std::vector<Lexer::Token>& tokens);
-        AST::ExpressionPtr parse();
+        explicit BasicExpressionParser(const std::vector<Lexer::Token>& tokens, Builder builder = Builder()); // tokens must outlive the parser
+        explicit BasicExpressionParser(std::vector<Lexer::Token>&& tokens, Builder builder = Builder());
+        explicit BasicExpressionParser(Lexer::TokenSource& source, Builder builder = Builder()); // parse straight from a (lazy) token source
+        Expression parse(); // throws Lexer::SyntaxError
+        Lexer::Result<Expression> tryParse(); // reports errors in the result instead
+
+        void setOptions(const ParseOptions& options) { this->options = options; }
     };
 
+    using ExpressionParser = BasicExpressionParser<AST::TreeBuilder>;
+    using FlatExpressionParser = BasicExpressionParser<AST::FlatBuilder>; // emits into a FlatTree
+
 } // namespace Parser
\ No newline at end of file
@@ -0,0 +1,362 @@
+#include "FlatAST.h"
+#include "Visitor.h"
+#include <iterator>
+#include <stdexcept>
+
+namespace AST {
+
+    NodeId FlatTree::addNode(NodeKind kind, NodeId a, NodeId b, NodeId c, Operator op, TextRef t, TextRef t2) {
+        if (kinds.size() >= NoNode) {
+            throw std::runtime_error("Flat AST exceeds 2^32 - 1 nodes");
+        }
+
+        NodeId id = static_cast<NodeId>(kinds.size());
+        kinds.push_back(kind);
+        first.push_back(a);
+        second.push_back(b);
+        third.push_back(c);
+        ops.push_back(op);
+        text.push_back(t);
+        text2.push_back(t2);
+        return id;
+    }
+
+    TextRef FlatTree::addText(std::string_view value) {
+        if (chars.size() + value.size() > 0xFFFFFFFFu) {
+            throw std::runtime_error("Flat AST text exceeds 4 GiB");
+        }
+
+        TextRef ref{ static_cast<std::uint32_t>(chars.size()), static_cast<std::uint32_t>(value.size()) };
+        chars.append(value);
+        return ref;
+    }
+
+    NodeId FlatTree::addList(const std::vector<NodeId>& ids) {
+        NodeId offset = static_cast<NodeId>(lists.size());
+        lists.insert(lists.end(), ids.begin(), ids.end());
+        return offset;
+    }
+
+    void FlatTree::clear() {
+        kinds.clear();
+        first.clear();
+        second.clear();
+        third.clear();
+        ops.clear();
+        text.clear();
+        text2.clear();
+        lists.clear();
+        numbers.clear();
+        chars.clear();
+        roots.clear();
+    }
+
+    namespace {
+
+        // Appends a class tree to a FlatTree, children before parents
+        class Flattener : public Visitor<Flattener, NodeId> {
+        public:
+            explicit Flattener(FlatTree& tree) : builder(tree) {}
+
+            NodeId visitNumber(const NumberLiteral& node) { return builder.number(node.value, node.number); }
+            NodeId visitIdentifier(const Identifier& node) { return builder.identifier(node.name); }
+            NodeId visitBoolean(const BooleanLiteral& node) { return builder.boolean(node.value); }
+            NodeId visitString(const StringLiteral& node) { return builder.string(node.value, node.decoded); }
+
+            NodeId visitBinary(const BinaryOperation& node) {
+                NodeId left = visit(*node.left);
+                NodeId right = visit(*node.right);
+                return builder.binary(left, node.operator_, right);
+            }
+
+            NodeId visitUnary(const UnaryOperation& node) {
+                return builder.unary(node.operator_, visit(*node.operand));
+            }
+
+            NodeId visitPreIncrement(const PreIncrement& node) {
+                return builder.preIncrement(node.op, node.variable);
+            }
+
+            NodeId visitPostIncrement(const PostIncrement& node) {
+                return builder.postIncrement(node.variable, node.op);
+            }
+
+            NodeId visitPostIncrementOperation(const PostIncrementOperation& node) {
+                return builder.postIncrement(node.variable, node.operator_);
+            }
+
+            NodeId visitVariableDeclaration(const VariableDeclaration& node) {
+                NodeId init = node.initializer ? visit(*node.initializer) : NoNode;
+                return builder.variableDeclaration(node.type, node.name, init);
+            }
+
+            NodeId visitAssignment(const AssignmentStatement& node) {
+                return builder.assignment(node.variable, visit(*node.value));
+            }
+
+            NodeId visitExpressionStatement(const ExpressionStatement& node) {
+                return builder.expressionStatement(visit(*node.expression));
+            }
+
+            NodeId visitBlock(const Block& node) {
+                std::vector<NodeId> statements;
+                statements.reserve(node.statements.size());
+                for (const auto& child : node.statements) {
+                    statements.push_back(visit(*child));
+                }
+                return builder.block(std::move(statements));
+            }
+
+            NodeId visitIf(const IfStatement& node) {
+                NodeId condition = visit(*node.condition);
+                NodeId thenStmt = visit(*node.thenStatement);
+                NodeId elseStmt = node.elseStatement ? visit(*node.elseStatement) : NoNode;
+                return builder.ifStatement(condition, thenStmt, elseStmt);
+            }
+
+        private:
+            FlatBuilder builder;
+        };
+
+    } // namespace
+
+    // Class tree -> flat
+    NodeId flatten(FlatTree& tree, const Expression& expr) {
+        return Flattener(tree).visit(expr);
+    }
+
+    NodeId flatten(FlatTree& tree, const Statement& stmt) {
+        return Flattener(tree).visit(stmt);
+    }
+
+    FlatTree flatten(const std::vector<StatementPtr>& statements) {
+        FlatTree tree;
+        for (const auto& stmt : statements) {
+            tree.roots.push_back(flatten(tree, *stmt));
+        }
+        return tree;
+    }
+
+    namespace {
+
+        // Builds a class tree from a flat one, children before parents. Nesting
+        // is followed with a heap stack, so deep trees cost heap, not call stack.
+        class Unflattener {
+        public:
+            explicit Unflattener(const FlatTree& tree) : tree(tree) {}
+
+            ExpressionPtr expression(NodeId id) {
+                run(id, false);
+                return popExpression();
+            }
+
+            StatementPtr statement(NodeId id) {
+                run(id, true);
+                return popStatement();
+            }
+
+        private:
+            struct Frame {
+                NodeId id;
+                bool statement; // what the parent expects the node to be
+                bool expanded;  // its children were pushed; build it next time
+            };
+
+            const FlatTree& tree;
+            std::vector<Frame> pending;
+            std::vector<ExpressionPtr> expressions; // built, not yet taken by their parent
+            std::vector<StatementPtr> statements;
+
+            std::string text(TextRef ref) const { return std::string(tree.textOf(ref)); }
+            Symbol name(TextRef ref) const { return Symbol::intern(tree.textOf(ref)); }
+
+            ExpressionPtr popExpression() {
+                ExpressionPtr expr = std::move(expressions.back());
+                expressions.pop_back();
+                return expr;
+            }
+
+            StatementPtr popStatement() {
+                StatementPtr stmt = std::move(statements.back());
+                statements.pop_back();
+                return stmt;
+            }
+
+            void run(NodeId root, bool statement) {
+                pending.push_back({ root, statement, false });
+                while (!pending.empty()) {
+                    Frame frame = pending.back();
+                    pending.pop_back();
+
+                    if (frame.expanded) {
+                        build(frame.id);
+                    }
+                    else {
+                        expand(frame);
+                    }
+                }
+            }
+
+            void push(NodeId id, bool statement) {
+                pending.push_back({ id, statement, false });
+            }
+
+            // Build a leaf now; otherwise push the node back to be built after
+            // its children, and the children in reverse so the first is built first
+            void expand(Frame frame) {
+                NodeId id = frame.id;
+                NodeKind kind = tree.kinds[id];
+                if (frame.statement ? !isStatement(kind) : !isExpression(kind)) {
+                    throw std::runtime_error(frame.statement ? "Flat node is not a statement" : "Flat node is not an expression");
+                }
+
+                switch (kind) {
+                case NodeKind::Number:
+                    expressions.push_back(makeNumber(text(tree.text[id]), tree.numbers[tree.first[id]]));
+                    return;
+                case NodeKind::Identifier:
+                    expressions.push_back(makeIdentifier(name(tree.text[id])));
+                    return;
+                case NodeKind::Boolean:
+                    expressions.push_back(makeBoolean(tree.first[id] != 0));
+                    return;
+                case NodeKind::String:
+                    expressions.push_back(makeString(text(tree.text[id]), tree.textOf(tree.text2[id])));
+                    return;
+                case NodeKind::PreIncrement:
+                    expressions.push_back(makePreIncrement(tree.ops[id], name(tree.text[id])));
+                    return;
+                case NodeKind::PostIncrement:
+                    expressions.push_back(makePostIncrement(name(tree.text[id]), tree.ops[id]));
+                    return;
+                default:
+                    break;
+                }
+
+                pending.push_back({ id, frame.statement, true });
+                switch (kind) {
+                case NodeKind::Binary:
+                    push(tree.second[id], false);
+                    push(tree.first[id], false);
+                    break;
+                case NodeKind::Unary:
+                case NodeKind::Assignment:
+                case NodeKind::ExpressionStatement:
+                    push(tree.first[id], false);
+                    break;
+                case NodeKind::VariableDeclaration:
+                    if (tree.first[id] != NoNode) {
+                        push(tree.first[id], false);
+                    }
+                    break;
+                case NodeKind::Block:
+                    for (const NodeId* child = tree.blockEnd(id); child != tree.blockBegin(id); ) {
+                        push(*--child, true);
+                    }
+                    break;
+                case NodeKind::If:
+                    if (tree.third[id] != NoNode) {
+                        push(tree.third[id], true);
+                    }
+                    push(tree.second[id], true);
+                    push(tree.first[id], false);
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            // Build a node whose children are on top of the result stacks
+            void build(NodeId id) {
+                switch (tree.kinds[id]) {
+                case NodeKind::Binary: {
+                    auto right = popExpression();
+                    auto left = popExpression();
+                    expressions.push_back(makeBinary(std::move(left), tree.ops[id], std::move(right)));
+                    break;
+                }
+                case NodeKind::Unary:
+                    expressions.push_back(makeUnary(tree.ops[id], popExpression()));
+                    break;
+                case NodeKind::VariableDeclaration: {
+                    ExpressionPtr init = tree.first[id] != NoNode ? popExpression() : nullptr;
+                    statements.push_back(makeVariableDeclaration(text(tree.text[id]), name(tree.text2[id]), std::move(init)));
+                    break;
+                }
+                case NodeKind::Assignment:
+                    statements.push_back(makeAssignment(name(tree.text[id]), popExpression()));
+                    break;
+                case NodeKind::ExpressionStatement:
+                    statements.push_back(makeExpressionStatement(popExpression()));
+                    break;
+                case NodeKind::Block: {
+                    auto first = statements.end() - (tree.blockEnd(id) - tree.blockBegin(id));
+                    std::vector<StatementPtr> children(std::make_move_iterator(first), std::make_move_iterator(statements.end()));
+                    statements.erase(first, statements.end());
+                    statements.push_back(makeBlock(std::move(children)));
+                    break;
+                }
+                case NodeKind::If: {
+                    StatementPtr elseStmt = tree.third[id] != NoNode ? popStatement() : nullptr;
+                    auto thenStmt = popStatement();
+                    auto condition = popExpression();
+                    statements.push_back(makeIf(std::move(condition), std::move(thenStmt), std::move(elseStmt)));
+                    break;
+                }
+                default:
+                    break;
+                }
+            }
+
+            static bool isExpression(NodeKind kind) {
+                switch (kind) {
+                case NodeKind::Number:
+                case NodeKind::Identifier:
+                case NodeKind::Boolean:
+                case NodeKind::String:
+                case NodeKind::Binary:
+                case NodeKind::Unary:
+                case NodeKind::PreIncrement:
+                case NodeKind::PostIncrement:
+                    return true;
+                default:
+                    return false;
+                }
+            }
+
+            static bool isStatement(NodeKind kind) {
+                switch (kind) {
+                case NodeKind::VariableDeclaration:
+                case NodeKind::Assignment:
+                case NodeKind::ExpressionStatement:
+                case NodeKind::Block:
+                case NodeKind::If:
+                    return true;
+                default:
+                    return false;
+                }
+            }
+        };
+
+    } // namespace
+
+    // Flat -> class tree
+    ExpressionPtr toExpression(const FlatTree& tree, NodeId id) {
+        return Unflattener(tree).expression(id);
+    }
+
+    StatementPtr toStatement(const FlatTree& tree, NodeId id) {
+        return Unflattener(tree).statement(id);
+    }
+
+    std::vector<StatementPtr> toStatements(const FlatTree& tree) {
+        std::vector<StatementPtr> statements;
+        statements.reserve(tree.roots.size());
+        Unflattener unflattener(tree);
+        for (NodeId root : tree.roots) {
+            statements.push_back(unflattener.statement(root));
+        }
+        return statements;
+    }
+
+} // namespace AST
\ No newline at end of file
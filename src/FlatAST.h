@@ -0,0 +1,171 @@
+#pragma once
+#include "AST.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AST {
+
+    // Index of a node in a FlatTree
+    using NodeId = std::uint32_t;
+    constexpr NodeId NoNode = 0xFFFFFFFFu;
+
+    // A slice of FlatTree::chars
+    struct TextRef {
+        std::uint32_t offset = 0;
+        std::uint32_t length = 0;
+    }; // struct TextRef
+
+    // Flat, index-based AST: one entry per node in each parallel array.
+    // Every array holds trivially copyable values, so copying a tree is a few
+    // memcpys, and children are referred to by 32-bit ids instead of pointers.
+    //
+    // Nodes use the class tree's NodeKind tags (PostIncrementOperation is
+    // stored as PostIncrement). Field use per kind (unused fields are NoNode /
+    // empty / TokenKind::None):
+    //   Number                       first = index into numbers, text = spelling
+    //   Identifier                   text = spelling
+    //   String                       text = spelling, text2 = contents with escapes decoded
+    //   Boolean                      first = 0 or 1
+    //   Binary                       first = left, second = right, op
+    //   Unary                        first = operand, op
+    //   PreIncrement, PostIncrement  op, text = variable
+    //   VariableDeclaration          first = initializer (optional), text = type, text2 = name
+    //   Assignment                   first = value, text = variable
+    //   ExpressionStatement          first = expression
+    //   Block                        first = offset into lists, second = statement count
+    //   If                           first = condition, second = then, third = else (optional)
+    //
+    // Names are kept as text rather than symbol ids: ids are only meaningful
+    // to the process that interned them, and a flat tree is plain data.
+    class FlatTree {
+    public:
+        std::vector<NodeKind> kinds;
+        std::vector<NodeId> first;
+        std::vector<NodeId> second;
+        std::vector<NodeId> third;
+        std::vector<Operator> ops;
+        std::vector<TextRef> text;
+        std::vector<TextRef> text2;
+
+        std::vector<NodeId> lists;        // statement ids of every block, one contiguous run per block
+        std::vector<NumberValue> numbers; // decoded values of number literals
+        std::string chars;                // text of all nodes
+        std::vector<NodeId> roots;        // top-level nodes
+
+        size_t size() const { return kinds.size(); }
+
+        NodeId addNode(NodeKind kind, NodeId a = NoNode, NodeId b = NoNode, NodeId c = NoNode,
+            Operator op = Operator::None, TextRef t = {}, TextRef t2 = {});
+        TextRef addText(std::string_view value);
+        NodeId addList(const std::vector<NodeId>& ids); // returns the offset of the run in lists
+
+        std::string_view textOf(TextRef ref) const {
+            return std::string_view(chars).substr(ref.offset, ref.length);
+        }
+
+        // Statement ids of a Block node
+        const NodeId* blockBegin(NodeId block) const { return lists.data() + first[block]; }
+        const NodeId* blockEnd(NodeId block) const { return blockBegin(block) + second[block]; }
+
+        void clear();
+    }; // class FlatTree
+
+    // Node builder that makes the parsers emit straight into a FlatTree
+    class FlatBuilder {
+    public:
+        using Expression = NodeId;
+        using Statement = NodeId;
+
+        static constexpr bool LazyBlocks = false; // blocks are always parsed in place
+
+        explicit FlatBuilder(FlatTree& tree) : tree(&tree) {}
+
+        static NodeId emptyExpression() { return NoNode; }
+        static NodeId emptyStatement() { return NoNode; }
+
+        NodeId number(std::string_view value, NumberValue number) {
+            NodeId index = static_cast<NodeId>(tree->numbers.size());
+            tree->numbers.push_back(number);
+            return tree->addNode(NodeKind::Number, index, NoNode, NoNode, Operator::None, tree->addText(value));
+        }
+
+        NodeId identifier(std::string_view name) {
+            return tree->addNode(NodeKind::Identifier, NoNode, NoNode, NoNode, Operator::None, tree->addText(name));
+        }
+
+        NodeId boolean(bool value) {
+            return tree->addNode(NodeKind::Boolean, value ? 1 : 0);
+        }
+
+        NodeId string(std::string_view value, std::string_view decoded) {
+            TextRef spelling = tree->addText(value);
+            // Without escapes the contents are the spelling between the quotes
+            TextRef contents = Lexer::hasEscapes(value) ? tree->addText(decoded)
+                : TextRef{ spelling.offset + 1, static_cast<std::uint32_t>(decoded.size()) };
+            return tree->addNode(NodeKind::String, NoNode, NoNode, NoNode, Operator::None, spelling, contents);
+        }
+
+        NodeId binary(NodeId left, Operator op, NodeId right) {
+            return tree->addNode(NodeKind::Binary, left, right, NoNode, op);
+        }
+
+        NodeId unary(Operator op, NodeId operand) {
+            return tree->addNode(NodeKind::Unary, operand, NoNode, NoNode, op);
+        }
+
+        NodeId preIncrement(Operator op, std::string_view variable) {
+            return tree->addNode(NodeKind::PreIncrement, NoNode, NoNode, NoNode, op, tree->addText(variable));
+        }
+
+        NodeId postIncrement(std::string_view variable, Operator op) {
+            return tree->addNode(NodeKind::PostIncrement, NoNode, NoNode, NoNode, op, tree->addText(variable));
+        }
+
+        // If expr is a plain identifier, store its name and return true
+        bool identifierName(NodeId expr, Symbol& name) const {
+            if (tree->kinds[expr] != NodeKind::Identifier) {
+                return false;
+            }
+            name = Symbol::intern(tree->textOf(tree->text[expr]));
+            return true;
+        }
+
+        NodeId variableDeclaration(std::string_view type, std::string_view name, NodeId init) {
+            TextRef typeText = tree->addText(type);
+            return tree->addNode(NodeKind::VariableDeclaration, init, NoNode, NoNode, Operator::None, typeText, tree->addText(name));
+        }
+
+        NodeId assignment(std::string_view variable, NodeId value) {
+            return tree->addNode(NodeKind::Assignment, value, NoNode, NoNode, Operator::None, tree->addText(variable));
+        }
+
+        NodeId expressionStatement(NodeId expr) {
+            return tree->addNode(NodeKind::ExpressionStatement, expr);
+        }
+
+        NodeId block(std::vector<NodeId> statements) {
+            NodeId offset = tree->addList(statements);
+            return tree->addNode(NodeKind::Block, offset, static_cast<NodeId>(statements.size()));
+        }
+
+        NodeId ifStatement(NodeId condition, NodeId thenStmt, NodeId elseStmt) {
+            return tree->addNode(NodeKind::If, condition, thenStmt, elseStmt);
+        }
+
+    private:
+        FlatTree* tree;
+    }; // class FlatBuilder
+
+    // Class tree -> flat (appends to tree and returns the new node's id)
+    NodeId flatten(FlatTree& tree, const Expression& expr);
+    NodeId flatten(FlatTree& tree, const Statement& stmt);
+    FlatTree flatten(const std::vector<StatementPtr>& statements); // roots = the statements
+
+    // Flat -> class tree (nodes come from the factory helpers, so an ArenaScope applies)
+    ExpressionPtr toExpression(const FlatTree& tree, NodeId id);
+    StatementPtr toStatement(const FlatTree& tree, NodeId id);
+    std::vector<StatementPtr> toStatements(const FlatTree& tree); // one per root
+
+} // namespace AST
\ No newline at end of file
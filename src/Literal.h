@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace Lexer {
+
+    // Decode a string literal: strip the quotes and replace the escapes
+    // \n \t \r \0 \\ \" \' by the bytes they stand for (any other escaped
+    // character stands for itself). Appends to out, a std::string or a
+    // std::pmr::string.
+    template <class String>
+    void decodeString(std::string_view raw, String& out) {
+        if (raw.size() < 2) {
+            return;
+        }
+        std::string_view body = raw.substr(1, raw.size() - 2);
+
+        for (size_t pos = 0; pos < body.size(); ) {
+            size_t escape = body.find('\\', pos);
+            if (escape == std::string_view::npos || escape + 1 >= body.size()) {
+                out.append(body.substr(pos));
+                break;
+            }
+
+            out.append(body.substr(pos, escape - pos));
+            char ch = body[escape + 1];
+            switch (ch) {
+            case 'n': out.push_back('\n'); break;
+            case 't': out.push_back('\t'); break;
+            case 'r': out.push_back('\r'); break;
+            case '0': out.push_back('\0'); break;
+            default:  out.push_back(ch); break; // \\, \", \' and anything else
+            }
+            pos = escape + 2;
+        }
+    }
+
+    // Contents of a string literal without escapes: the spelling between
+    // the quotes (empty if raw is not quoted)
+    inline std::string_view stringSlice(std::string_view raw) {
+        return raw.size() < 2 ? std::string_view() : raw.substr(1, raw.size() - 2);
+    }
+
+    // True if decodeString() would differ from stringSlice()
+    inline bool hasEscapes(std::string_view raw) {
+        return raw.find('\\') != std::string_view::npos;
+    }
+
+} // namespace Lexer
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+
+namespace Lexer {
+
+    // Decoded value of a number literal
+    struct NumberValue {
+        bool isInteger = true;
+        std::int64_t integer = 0; // value of an integer literal
+        double real = 0;          // value as a double (integers too)
+    }; // struct NumberValue
+
+    // Decode a number literal ("42", "3.14"). Integers must fit in 64 bits and
+    // decimals in a double; returns false when the literal is out of range.
+    // Decimals too small for a double decode as 0.
+    inline bool decodeNumber(std::string_view text, NumberValue& value) {
+        const char* first = text.data();
+        const char* last = first + text.size();
+        size_t point = text.find('.');
+
+        if (point == std::string_view::npos) {
+            value.isInteger = true;
+            auto [end, ec] = std::from_chars(first, last, value.integer);
+            value.real = static_cast<double>(value.integer);
+            return ec == std::errc() && end == last;
+        }
+
+        value.isInteger = false;
+        value.integer = 0;
+        auto [end, ec] = std::from_chars(first, last, value.real);
+        if (ec == std::errc::result_out_of_range && text.find_first_not_of('0') == point) {
+            value.real = 0; // underflow: only zeros before the point
+            return true;
+        }
+        return ec == std::errc() && end == last;
+    }
+
+} // namespace Lexer
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#include "TokenKind.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Lexer {
+
+    // Maximal-munch recognizer for operators and punctuation, generated at
+    // compile time from operatorSpellings. Each byte costs one class lookup
+    // and one transition lookup, whatever the length of the longest operator,
+    // so adding e.g. a three-character operator is just a new spelling.
+    class OperatorDfa {
+    public:
+        static constexpr size_t MaxStates = 64;
+        static constexpr size_t MaxClasses = 32;
+
+        constexpr OperatorDfa() {
+            // Character classes: one per byte that appears in any spelling
+            for (size_t i = 0; i < OperatorCount; ++i) {
+                for (char ch : operatorSpellings[i]) {
+                    auto& cls = classes[static_cast<unsigned char>(ch)];
+                    if (cls == 0) {
+                        cls = static_cast<std::uint8_t>(classCount++);
+                    }
+                }
+            }
+
+            // States form a trie over the spellings; state 0 is the start
+            for (size_t i = 0; i < OperatorCount; ++i) {
+                size_t state = 0;
+                for (char ch : operatorSpellings[i]) {
+                    auto& next = transitions[state][classes[static_cast<unsigned char>(ch)]];
+                    if (next == 0) {
+                        next = static_cast<std::uint8_t>(stateCount++);
+                    }
+                    state = next;
+                }
+                accepts[state] = static_cast<TokenKind>(static_cast<size_t>(FirstOperator) + i);
+            }
+        }
+
+        // Longest operator or punctuation at input[pos]. Sets length to 0 and
+        // returns TokenKind::None when no operator starts there.
+        constexpr TokenKind match(std::string_view input, size_t pos, size_t& length) const {
+            TokenKind best = TokenKind::None;
+            length = 0;
+
+            size_t state = 0;
+            for (size_t i = pos; i < input.size(); ++i) {
+                state = transitions[state][classes[static_cast<unsigned char>(input[i])]];
+                if (state == 0) {
+                    break;
+                }
+                if (accepts[state] != TokenKind::None) {
+                    best = accepts[state];
+                    length = i - pos + 1;
+                }
+            }
+            return best;
+        }
+
+        size_t classCount = 1;  // class 0: bytes that never start or continue an operator
+        size_t stateCount = 1;  // state 0: start, also the dead state as a target
+        std::uint8_t classes[256] = {};
+        std::uint8_t transitions[MaxStates][MaxClasses] = {};
+        TokenKind accepts[MaxStates] = {};
+    }; // class OperatorDfa
+
+    inline constexpr OperatorDfa operatorDfa{};
+    static_assert(operatorDfa.classCount <= OperatorDfa::MaxClasses, "Too many operator characters for the DFA");
+    static_assert(operatorDfa.stateCount <= OperatorDfa::MaxStates, "Too many operator prefixes for the DFA");
+
+    constexpr bool operatorDfaRoundTrips() {
+        for (size_t i = 0; i < OperatorCount; ++i) {
+            size_t length = 0;
+            TokenKind kind = operatorDfa.match(operatorSpellings[i], 0, length);
+            if (kind != static_cast<TokenKind>(static_cast<size_t>(FirstOperator) + i) ||
+                length != operatorSpellings[i].size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(operatorDfaRoundTrips(), "Every operator must be recognized as itself");
+
+} // namespace Lexer
\ No newline at end of file
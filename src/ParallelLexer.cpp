@@ -0,0 +1,141 @@
+// ParallelLexer.cpp
+#include "ParallelLexer.h"
+#include "Scanner.h"
+#include <algorithm>
+#include <limits>
+
+namespace Lexer {
+
+    namespace {
+
+        // One slice of the input and the tokens that start in it
+        struct Chunk {
+            size_t begin = 0;
+            size_t end = 0;
+            size_t first = 0;                // where lexing from begin finds its first token
+            std::vector<PackedToken> tokens;
+            size_t reach = 0;                // where the next token would be looked for
+            Error error;                     // lexing failed at reach
+        };
+
+        // Lex the tokens that start in [pos, chunk.end)
+        void lexFrom(std::string_view input, size_t pos, Chunk& chunk) {
+            PackedToken token{};
+            while (true) {
+                pos = skipWhitespace(input, pos);
+                if (pos >= chunk.end || !nextToken(input, pos, token, chunk.error)) {
+                    break;
+                }
+                chunk.tokens.push_back(token);
+            }
+            chunk.reach = pos;
+        }
+
+        // The previous chunk ended at pos instead of chunk.first: a token ran
+        // across the cut. Lex from pos until a token starts where one of the
+        // speculative tokens does; from there on they are what sequential
+        // lexing produces, since a token depends only on where it starts.
+        void realign(std::string_view input, size_t pos, Chunk& chunk) {
+            std::vector<PackedToken> fixed;
+            Error error;
+            PackedToken token{};
+
+            while (true) {
+                pos = skipWhitespace(input, pos);
+                if (pos >= chunk.end) {
+                    chunk.reach = pos;
+                    chunk.error = Error();
+                    break;
+                }
+
+                auto same = std::lower_bound(chunk.tokens.begin(), chunk.tokens.end(), pos,
+                    [](const PackedToken& t, size_t offset) { return t.offset < offset; });
+                if (same != chunk.tokens.end() && same->offset == pos) {
+                    fixed.insert(fixed.end(), same, chunk.tokens.end());
+                    break; // reach and error stay those of the speculative pass
+                }
+
+                if (!nextToken(input, pos, token, error)) {
+                    chunk.reach = pos;
+                    chunk.error = std::move(error);
+                    break;
+                }
+                fixed.push_back(token);
+            }
+
+            chunk.tokens = std::move(fixed);
+        }
+
+    } // namespace
+
+    bool tokenizeParallel(std::string_view input, std::vector<PackedToken>& out, Util::ThreadPool& pool, Error& error,
+        size_t chunkBytes) {
+        // Offsets are 32-bit to keep the record small
+        if (input.length() > std::numeric_limits<std::uint32_t>::max()) {
+            error.code = ErrorCode::InputTooLarge;
+            return false;
+        }
+
+        if (chunkBytes == 0) {
+            if (pool.size() == 1) {
+                return tokenizeInto(input, out, error); // nothing to overlap with
+            }
+            chunkBytes = std::max<size_t>(64 * 1024, input.size() / (pool.size() * 4) + 1);
+        }
+
+        // Cut just after newlines: line comments end there, and few tokens span lines
+        std::vector<Chunk> chunks;
+        for (size_t begin = 0; begin < input.size(); ) {
+            size_t end = input.size();
+            if (input.size() - begin > chunkBytes) {
+                size_t newline = input.find('\n', begin + chunkBytes);
+                end = newline == std::string_view::npos ? input.size() : newline + 1;
+            }
+            chunks.emplace_back();
+            chunks.back().begin = begin;
+            chunks.back().end = end;
+            begin = end;
+        }
+
+        pool.forEach(chunks.size(), [&](size_t index) {
+            Chunk& chunk = chunks[index];
+            chunk.first = skipWhitespace(input, chunk.begin);
+            lexFrom(input, chunk.begin, chunk);
+        });
+
+        // Join in order, repairing chunks whose start was not between tokens
+        size_t total = 0;
+        size_t pos = 0;
+        size_t used = 0;
+        for (Chunk& chunk : chunks) {
+            if (pos != chunk.first) {
+                realign(input, pos, chunk);
+            }
+            total += chunk.tokens.size();
+            used++;
+            if (chunk.error) {
+                break;
+            }
+            pos = chunk.reach;
+        }
+
+        out.reserve(out.size() + total);
+        for (size_t i = 0; i < used; ++i) {
+            out.insert(out.end(), chunks[i].tokens.begin(), chunks[i].tokens.end());
+        }
+
+        if (used > 0 && chunks[used - 1].error) {
+            error = std::move(chunks[used - 1].error);
+            return false;
+        }
+        return true;
+    }
+
+    void tokenizeParallel(std::string_view input, std::vector<PackedToken>& out, Util::ThreadPool& pool, size_t chunkBytes) {
+        Error error;
+        if (!tokenizeParallel(input, out, pool, error, chunkBytes)) {
+            throw SyntaxError(std::move(error));
+        }
+    }
+
+} // namespace Lexer
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+#include "Tokenizer.h"
+#include "ThreadPool.h"
+#include <string_view>
+#include <vector>
+
+namespace Lexer {
+
+    // tokenizeInto() on several threads. The input is cut into chunks just
+    // after newlines and every chunk is lexed as if it started between tokens.
+    // The chunks are then joined in order: where a token of one chunk runs
+    // into the next (a string or block comment spanning the cut), the next
+    // chunk is lexed again from the true position until it falls back in
+    // step with its speculative tokens. The result, including any error, is
+    // exactly that of tokenizeInto().
+    //
+    // chunkBytes: approximate chunk size (0 = a few chunks per thread, or a
+    // plain tokenizeInto() on a one-thread pool)
+    bool tokenizeParallel(std::string_view input, std::vector<PackedToken>& out, Util::ThreadPool& pool, Error& error,
+        size_t chunkBytes = 0);
+    void tokenizeParallel(std::string_view input, std::vector<PackedToken>& out, Util::ThreadPool& pool,
+        size_t chunkBytes = 0); // throws SyntaxError
+
+} // namespace Lexer
\ No newline at end of file
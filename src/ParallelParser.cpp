@@ -0,0 +1,104 @@
+// ParallelParser.cpp
+#include "ParallelParser.h"
+#include <algorithm>
+#include <iterator>
+
+namespace Parser {
+
+    size_t topLevelEnd(const std::vector<Lexer::Token>& tokens, size_t begin) {
+        long depth = 0;
+        for (size_t i = begin; i < tokens.size(); ++i) {
+            switch (tokens[i].kind) {
+            case Lexer::TokenKind::LeftParen:
+            case Lexer::TokenKind::LeftBrace:
+            case Lexer::TokenKind::LeftBracket:
+                ++depth;
+                continue;
+
+            case Lexer::TokenKind::RightParen:
+            case Lexer::TokenKind::RightBracket:
+                --depth;
+                continue;
+
+            case Lexer::TokenKind::RightBrace:
+                --depth;
+                break;
+
+            case Lexer::TokenKind::Semicolon:
+                break;
+
+            default:
+                continue;
+            }
+
+            // A statement may end after this token
+            size_t next = i + 1;
+            if (depth == 0 && next < tokens.size() && tokens[next].kind != Lexer::TokenKind::KwElse) {
+                return next;
+            }
+        }
+        return tokens.size();
+    }
+
+    std::vector<size_t> splitTopLevel(const std::vector<Lexer::Token>& tokens, size_t minTokens) {
+        std::vector<size_t> starts;
+        if (tokens.empty()) {
+            return starts;
+        }
+
+        starts.push_back(0);
+        for (size_t next = topLevelEnd(tokens, 0); next < tokens.size(); next = topLevelEnd(tokens, next)) {
+            if (next - starts.back() >= minTokens) {
+                starts.push_back(next);
+            }
+        }
+        return starts;
+    }
+
+    Program<AST::StatementPtr> parseProgramParallel(const std::vector<Lexer::Token>& tokens, Util::ThreadPool& pool,
+        ParseOptions options) {
+        // Errors inside blocks are part of the diagnostics, as in parseProgram()
+        options.lazyBlocks = false;
+
+        // A few chunks per thread, so threads that finish early can steal
+        constexpr size_t MinChunkTokens = 1024;
+        size_t target = std::max(MinChunkTokens, tokens.size() / (pool.size() * 8) + 1);
+        std::vector<size_t> starts = splitTopLevel(tokens, target);
+        starts.push_back(tokens.size());
+
+        size_t chunks = starts.size() - 1;
+        std::vector<Lexer::Result<std::vector<AST::StatementPtr>>> results(chunks);
+
+        pool.forEach(chunks, [&](size_t chunk) {
+            AST::HeapScope heap; // the same on every thread
+            Lexer::VectorTokenSource source(tokens.data() + starts[chunk], starts[chunk + 1] - starts[chunk]);
+            StatementParser parser(source);
+            parser.setOptions(options);
+            results[chunk] = parser.tryParseStatements();
+        });
+
+        // Stitch in source order. A chunk that fails may have been cut where
+        // the sequential parser would not stop, so from there on parse the
+        // rest sequentially: it sees exactly what parseProgram() would.
+        Program<AST::StatementPtr> program;
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            if (!results[chunk]) {
+                AST::HeapScope heap;
+                Lexer::VectorTokenSource rest(tokens.data() + starts[chunk], tokens.size() - starts[chunk]);
+                StatementParser parser(rest);
+                parser.setOptions(options);
+                Program<AST::StatementPtr> tail = parser.parseProgram();
+
+                std::move(tail.statements.begin(), tail.statements.end(), std::back_inserter(program.statements));
+                program.diagnostics = std::move(tail.diagnostics);
+                break;
+            }
+
+            auto& statements = results[chunk].value;
+            std::move(statements.begin(), statements.end(), std::back_inserter(program.statements));
+        }
+
+        return program;
+    }
+
+} // namespace Parser
\ No newline at end of file
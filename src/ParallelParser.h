@@ -0,0 +1,29 @@
+#pragma once
+#include "StatementParser.h"
+#include "ThreadPool.h"
+#include <vector>
+
+namespace Parser {
+
+    // Index just past the top-level statement that starts at token 'begin'
+    // (the token count if it runs to the end). A statement ends at a ';' or
+    // '}' outside every bracket, unless an 'else' follows.
+    size_t topLevelEnd(const std::vector<Lexer::Token>& tokens, size_t begin);
+
+    // Split a token stream between top-level statements. Chunks hold at
+    // least minTokens tokens (the last one may be shorter). Returns the
+    // index of the first token of every chunk.
+    std::vector<size_t> splitTopLevel(const std::vector<Lexer::Token>& tokens, size_t minTokens);
+
+    // parseProgram() with the top-level statements parsed concurrently on
+    // pool, stitched back together in source order. The statements and
+    // diagnostics are the same as a sequential StatementParser::parseProgram():
+    // from the first chunk that fails, the rest is parsed sequentially.
+    //
+    // Nodes are always allocated on the heap: an ArenaScope is per thread,
+    // so it would otherwise hold whichever chunks the calling thread
+    // happened to parse.
+    Program<AST::StatementPtr> parseProgramParallel(const std::vector<Lexer::Token>& tokens, Util::ThreadPool& pool,
+        ParseOptions options = {});
+
+} // namespace Parser
\ No newline at end of file
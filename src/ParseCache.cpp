@@ -0,0 +1,124 @@
+// ParseCache.cpp
+#include "ParseCache.h"
+#include <cstring>
+
+namespace Parser {
+
+    SharedParse parseSource(std::string_view source, ParseMode mode) {
+        auto parsed = std::make_shared<ParsedSource>();
+        parsed->source_.assign(source);
+        parsed->mode_ = mode;
+
+        // The result may outlive any arena of this thread
+        AST::HeapScope heap;
+        Lexer::StringTokenSource tokens(parsed->source_);
+
+        switch (mode) {
+        case ParseMode::Expression: {
+            auto result = ExpressionParser(tokens).tryParse();
+            parsed->expression_ = std::move(result.value);
+            parsed->error_ = std::move(result.error);
+            break;
+        }
+        case ParseMode::Statement: {
+            auto result = StatementParser(tokens).tryParse();
+            if (result) {
+                parsed->statements_.push_back(std::move(result.value));
+            }
+            parsed->error_ = std::move(result.error);
+            break;
+        }
+        case ParseMode::Statements: {
+            auto result = StatementParser(tokens).tryParseStatements();
+            parsed->statements_ = std::move(result.value);
+            parsed->error_ = std::move(result.error);
+            break;
+        }
+        }
+        return parsed;
+    }
+
+    std::uint64_t hashSource(std::string_view source) {
+        constexpr std::uint64_t Multiplier = 0x9E3779B97F4A7C15ull;
+        auto mix = [](std::uint64_t hash, std::uint64_t word) {
+            hash = (hash ^ word) * Multiplier;
+            return hash ^ (hash >> 32);
+        };
+
+        std::uint64_t hash = source.size() * Multiplier;
+        size_t i = 0;
+        for (; i + 8 <= source.size(); i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, source.data() + i, 8);
+            hash = mix(hash, word);
+        }
+
+        std::uint64_t tail = 0;
+        if (i < source.size()) {
+            std::memcpy(&tail, source.data() + i, source.size() - i);
+        }
+        return mix(hash, tail);
+    }
+
+    ParseCache::ParseCache(size_t capacity) : capacity_(capacity) {
+    }
+
+    SharedParse ParseCache::parse(std::string_view source, ParseMode mode) {
+        Key key{ hashSource(source), mode };
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = index.find(key);
+            if (found != index.end() && found->second->parsed->source() == source) {
+                entries.splice(entries.begin(), entries, found->second);
+                counters.hits++;
+                return found->second->parsed;
+            }
+            counters.misses++;
+        }
+
+        SharedParse parsed = parseSource(source, mode);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        insert(key, parsed);
+        return parsed;
+    }
+
+    // A text whose hash matches a different one replaces it
+    void ParseCache::insert(const Key& key, SharedParse parsed) {
+        if (capacity_ == 0) {
+            return;
+        }
+
+        auto found = index.find(key);
+        if (found != index.end()) {
+            found->second->parsed = std::move(parsed);
+            entries.splice(entries.begin(), entries, found->second);
+            return;
+        }
+
+        if (entries.size() >= capacity_) {
+            index.erase(entries.back().key);
+            entries.pop_back();
+            counters.evictions++;
+        }
+        entries.push_front({ key, std::move(parsed) });
+        index.emplace(key, entries.begin());
+    }
+
+    ParseCacheStats ParseCache::stats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return counters;
+    }
+
+    size_t ParseCache::size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    void ParseCache::clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        index.clear();
+    }
+
+} // namespace Parser
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+#include "StatementParser.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Parser {
+
+    // What to parse the text as
+    enum class ParseMode : std::uint8_t {
+        Expression, // one expression (ExpressionParser::parse())
+        Statement,  // one statement (StatementParser::parse())
+        Statements  // a whole program (StatementParser::parseStatements())
+    }; // enum ParseMode
+
+    class ParsedSource;
+    using SharedParse = std::shared_ptr<const ParsedSource>;
+
+    // Parse without the cache
+    SharedParse parseSource(std::string_view source, ParseMode mode);
+
+    // Parse result of one text. Shared between cache hits, so it is never
+    // changed after it is made: the trees are only handed out as const
+    // nodes, and are on the heap whatever arena the parsing thread had active.
+    class ParsedSource {
+    public:
+        const std::string& source() const { return source_; }
+        ParseMode mode() const { return mode_; }
+        const Lexer::Error& error() const { return error_; } // set if the text does not parse
+        bool ok() const { return !error_; }
+
+        // Expression mode, if ok()
+        const AST::Expression& expression() const { return *expression_; }
+
+        // Statement (one) and Statements modes
+        size_t statementCount() const { return statements_.size(); }
+        const AST::Statement& statement(size_t index) const { return *statements_[index]; }
+
+    private:
+        friend SharedParse parseSource(std::string_view source, ParseMode mode);
+
+        std::string source_;
+        ParseMode mode_ = ParseMode::Expression;
+        AST::ExpressionPtr expression_;
+        std::vector<AST::StatementPtr> statements_;
+        Lexer::Error error_;
+    }; // class ParsedSource
+
+    // 64-bit hash of a text, eight bytes at a time
+    std::uint64_t hashSource(std::string_view source);
+
+    struct ParseCacheStats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+    }; // struct ParseCacheStats
+
+    // Bounded LRU cache of parse results, keyed by a hash of the text and the
+    // mode, for callers that parse the same snippets again and again. A hit
+    // costs the hash and one comparison of the text, and returns the tree
+    // made by the first parse; errors are cached too. Safe to share between
+    // threads: texts are parsed outside the lock.
+    class ParseCache {
+    public:
+        static constexpr size_t DefaultCapacity = 1024;
+
+        explicit ParseCache(size_t capacity = DefaultCapacity);
+
+        ParseCache(const ParseCache&) = delete;
+        ParseCache& operator=(const ParseCache&) = delete;
+
+        // The cached result for (source, mode), parsing it on a miss
+        SharedParse parse(std::string_view source, ParseMode mode);
+
+        ParseCacheStats stats() const;
+        size_t size() const;
+        size_t capacity() const { return capacity_; }
+
+        // Drop every entry (results already handed out stay valid)
+        void clear();
+
+    private:
+        struct Key {
+            std::uint64_t hash;
+            ParseMode mode;
+
+            bool operator==(const Key& other) const { return hash == other.hash && mode == other.mode; }
+        }; // struct Key
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const { return static_cast<size_t>(key.hash) ^ static_cast<size_t>(key.mode); }
+        }; // struct KeyHash
+
+        struct Entry {
+            Key key;
+            SharedParse parsed;
+        }; // struct Entry
+
+        void insert(const Key& key, SharedParse parsed); // with the mutex held
+
+        size_t capacity_;
+        mutable std::mutex mutex;
+        std::list<Entry> entries; // most recently used first
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+        ParseCacheStats counters;
+    }; // class ParseCache
+
+} // namespace Parser
\ No newline at end of file
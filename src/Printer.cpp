@@ -0,0 +1,338 @@
+#include "Printer.h"
+
+namespace AST {
+
+    Printer::Printer(std::string& out, PrintOptions options)
+        : out(&out), stream(nullptr), options(options) {
+    }
+
+    Printer::Printer(std::ostream& stream, PrintOptions options)
+        : out(&buffer), stream(&stream), options(options) {
+        buffer.reserve(StreamFlushSize);
+    }
+
+    Printer::~Printer() {
+        flush();
+    }
+
+    void Printer::print(const ASTNode& node) {
+        child(node);
+    }
+
+    void Printer::child(const ASTNode& node) {
+        if (recursion >= RecursionLimit) {
+            printIterative(node);
+            return;
+        }
+
+        ++recursion;
+        visit(node);
+        --recursion;
+    }
+
+    void Printer::flush() {
+        if (stream && !buffer.empty()) {
+            stream->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+
+    void Printer::write(std::string_view text) {
+        out->append(text);
+        if (stream && buffer.size() >= StreamFlushSize) {
+            flush();
+        }
+    }
+
+    void Printer::writeSpaces(size_t count) {
+        out->append(count, ' ');
+    }
+
+    // Expressions
+    void Printer::visitNumber(const NumberLiteral& node) {
+        write(node.value);
+    }
+
+    void Printer::visitIdentifier(const Identifier& node) {
+        write(node.name);
+    }
+
+    void Printer::visitBoolean(const BooleanLiteral& node) {
+        write(node.value ? "true" : "false");
+    }
+
+    void Printer::visitString(const StringLiteral& node) {
+        write(node.value); // includes the quotes
+    }
+
+    void Printer::visitBinary(const BinaryOperation& node) {
+        write("(");
+        child(*node.left);
+        write(" ");
+        write(Lexer::tokenKindText(node.operator_));
+        write(" ");
+        child(*node.right);
+        write(")");
+    }
+
+    void Printer::visitUnary(const UnaryOperation& node) {
+        write("(");
+        write(Lexer::tokenKindText(node.operator_));
+        write(" ");
+        child(*node.operand);
+        write(")");
+    }
+
+    void Printer::visitPreIncrement(const PreIncrement& node) {
+        write("(");
+        write(Lexer::tokenKindText(node.op));
+        write(node.variable);
+        write(")");
+    }
+
+    void Printer::visitPostIncrement(const PostIncrement& node) {
+        write("(");
+        write(node.variable);
+        write(Lexer::tokenKindText(node.op));
+        write(")");
+    }
+
+    void Printer::visitPostIncrementOperation(const PostIncrementOperation& node) {
+        write("(");
+        write(node.variable);
+        write(Lexer::tokenKindText(node.operator_));
+        write(")");
+    }
+
+    // Statements
+    void Printer::visitVariableDeclaration(const VariableDeclaration& node) {
+        write(node.type);
+        write(" ");
+        write(node.name);
+        if (node.initializer) {
+            write(" = ");
+            child(*node.initializer);
+        }
+        write(";");
+    }
+
+    void Printer::visitAssignment(const AssignmentStatement& node) {
+        write(node.variable);
+        write(" = ");
+        child(*node.value);
+        write(";");
+    }
+
+    void Printer::visitExpressionStatement(const ExpressionStatement& node) {
+        child(*node.expression);
+        write(";");
+    }
+
+    // Statements sit one level in from their braces. toString() layout uses
+    // that single level at every depth; indentBlocks indents by nesting depth.
+    void Printer::visitBlock(const Block& node) {
+        size_t level = options.indentBlocks ? depth : 0;
+
+        write("{\n");
+        ++depth;
+        for (const auto& stmt : node.statements) {
+            writeSpaces((level + 1) * options.indentWidth);
+            child(*stmt);
+            write("\n");
+        }
+        --depth;
+        writeSpaces(level * options.indentWidth);
+        write("}");
+    }
+
+    void Printer::visitIf(const IfStatement& node) {
+        write("if (");
+        child(*node.condition);
+        write(") ");
+        child(*node.thenStatement);
+        if (node.elseStatement) {
+            write(" else ");
+            child(*node.elseStatement);
+        }
+    }
+
+    // Deep subtrees: same output as the visit methods, driven by a heap stack
+    void Printer::printIterative(const ASTNode& node) {
+        pending.clear();
+        pushNode(node, depth);
+
+        while (!pending.empty()) {
+            Item item = pending.back();
+            pending.pop_back();
+
+            if (item.node) {
+                expand(*item.node, item.depth);
+            }
+            else {
+                writeSpaces(item.spaces);
+                write(item.text);
+            }
+        }
+    }
+
+    // Write the text of node up to its first child and push the rest (children
+    // and the text between them) in reverse, so the next pop is the first child
+    void Printer::expand(const ASTNode& node, size_t depth) {
+        switch (node.kind) {
+        // Expressions
+        case NodeKind::Number:
+            write(static_cast<const NumberLiteral&>(node).value);
+            break;
+
+        case NodeKind::Identifier:
+            write(static_cast<const Identifier&>(node).name);
+            break;
+
+        case NodeKind::Boolean:
+            write(static_cast<const BooleanLiteral&>(node).value ? "true" : "false");
+            break;
+
+        case NodeKind::String:
+            write(static_cast<const StringLiteral&>(node).value); // includes the quotes
+            break;
+
+        case NodeKind::Binary: {
+            auto& binary = static_cast<const BinaryOperation&>(node);
+            write("(");
+            pushText(")");
+            pushNode(*binary.right, depth);
+            pushText(" ");
+            pushText(Lexer::tokenKindText(binary.operator_));
+            pushText(" ");
+            pushNode(*binary.left, depth);
+            break;
+        }
+
+        case NodeKind::Unary: {
+            auto& unary = static_cast<const UnaryOperation&>(node);
+            write("(");
+            write(Lexer::tokenKindText(unary.operator_));
+            write(" ");
+            pushText(")");
+            pushNode(*unary.operand, depth);
+            break;
+        }
+
+        case NodeKind::PreIncrement: {
+            auto& increment = static_cast<const PreIncrement&>(node);
+            write("(");
+            write(Lexer::tokenKindText(increment.op));
+            write(increment.variable);
+            write(")");
+            break;
+        }
+
+        case NodeKind::PostIncrement: {
+            auto& increment = static_cast<const PostIncrement&>(node);
+            write("(");
+            write(increment.variable);
+            write(Lexer::tokenKindText(increment.op));
+            write(")");
+            break;
+        }
+
+        case NodeKind::PostIncrementOperation: {
+            auto& increment = static_cast<const PostIncrementOperation&>(node);
+            write("(");
+            write(increment.variable);
+            write(Lexer::tokenKindText(increment.operator_));
+            write(")");
+            break;
+        }
+
+        // Statements
+        case NodeKind::VariableDeclaration: {
+            auto& declaration = static_cast<const VariableDeclaration&>(node);
+            write(declaration.type);
+            write(" ");
+            write(declaration.name);
+            if (declaration.initializer) {
+                write(" = ");
+                pushText(";");
+                pushNode(*declaration.initializer, depth);
+            }
+            else {
+                write(";");
+            }
+            break;
+        }
+
+        case NodeKind::Assignment: {
+            auto& assignment = static_cast<const AssignmentStatement&>(node);
+            write(assignment.variable);
+            write(" = ");
+            pushText(";");
+            pushNode(*assignment.value, depth);
+            break;
+        }
+
+        case NodeKind::ExpressionStatement:
+            pushText(";");
+            pushNode(*static_cast<const ExpressionStatement&>(node).expression, depth);
+            break;
+
+        // Statements sit one level in from their braces. toString() layout uses
+        // that single level at every depth; indentBlocks indents by nesting depth.
+        case NodeKind::Block: {
+            auto& block = static_cast<const Block&>(node);
+            size_t level = options.indentBlocks ? depth : 0;
+
+            write("{\n");
+            pushText("}", level * options.indentWidth);
+            for (auto stmt = block.statements.rbegin(); stmt != block.statements.rend(); ++stmt) {
+                pushText("\n");
+                pushNode(**stmt, depth + 1);
+                pushText("", (level + 1) * options.indentWidth);
+            }
+            break;
+        }
+
+        case NodeKind::If: {
+            auto& ifStatement = static_cast<const IfStatement&>(node);
+            write("if (");
+            if (ifStatement.elseStatement) {
+                pushNode(*ifStatement.elseStatement, depth);
+                pushText(" else ");
+            }
+            pushNode(*ifStatement.thenStatement, depth);
+            pushText(") ");
+            pushNode(*ifStatement.condition, depth);
+            break;
+        }
+
+        case NodeKind::LazyBlock:
+            expand(static_cast<const LazyBlock&>(node).body(), depth);
+            break;
+        }
+    }
+
+    // Convenience entry points
+    void print(const ASTNode& node, std::string& out, PrintOptions options) {
+        Printer(out, options).print(node);
+    }
+
+    void print(const ASTNode& node, std::ostream& stream, PrintOptions options) {
+        Printer(stream, options).print(node);
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const ASTNode& node) {
+        print(node, stream);
+        return stream;
+    }
+
+    std::string toString(const ASTNode& node, PrintOptions options) {
+        std::string result;
+        print(node, result, options);
+        return result;
+    }
+
+    std::string ASTNode::toString() const {
+        return AST::toString(*this);
+    }
+
+} // namespace AST
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+#include "AST.h"
+#include "Visitor.h"
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AST {
+
+    struct PrintOptions {
+        bool indentBlocks = false; // indent nested block bodies by depth (default: toString() layout)
+        size_t indentWidth = 2;    // spaces per block level
+    }; // struct PrintOptions
+
+    // Prints a tree in one linear pass, appending to a caller-owned string or
+    // streaming to an std::ostream through an internal buffer. With default
+    // options the output is exactly ASTNode::toString().
+    //
+    // Printing recurses for ordinary trees; past RecursionLimit levels the
+    // rest of a subtree is printed from a heap stack instead, so arbitrarily
+    // deep trees print without exhausting the C++ stack.
+    class Printer : private Visitor<Printer> {
+    public:
+        static constexpr size_t StreamFlushSize = 64 * 1024;
+        static constexpr size_t RecursionLimit = 512;
+
+        explicit Printer(std::string& out, PrintOptions options = {});
+        explicit Printer(std::ostream& stream, PrintOptions options = {});
+        ~Printer();
+
+        Printer(const Printer&) = delete;
+        Printer& operator=(const Printer&) = delete;
+
+        void print(const ASTNode& node);
+        void flush(); // write buffered output to the stream (no-op for string output)
+
+    private:
+        friend class Visitor<Printer>;
+
+        void visitNumber(const NumberLiteral& node);
+        void visitIdentifier(const Identifier& node);
+        void visitBoolean(const BooleanLiteral& node);
+        void visitString(const StringLiteral& node);
+        void visitBinary(const BinaryOperation& node);
+        void visitUnary(const UnaryOperation& node);
+        void visitPreIncrement(const PreIncrement& node);
+        void visitPostIncrement(const PostIncrement& node);
+        void visitPostIncrementOperation(const PostIncrementOperation& node);
+        void visitVariableDeclaration(const VariableDeclaration& node);
+        void visitAssignment(const AssignmentStatement& node);
+        void visitExpressionStatement(const ExpressionStatement& node);
+        void visitBlock(const Block& node);
+        void visitIf(const IfStatement& node);
+
+        void child(const ASTNode& node); // visit, or hand over to printIterative() when too deep
+
+        // A node to expand, or spaces followed by text to write
+        struct Item {
+            const ASTNode* node;
+            std::string_view text;
+            size_t spaces;
+            size_t depth; // block nesting of node
+        };
+
+        void printIterative(const ASTNode& node);
+        void expand(const ASTNode& node, size_t depth);
+        void pushNode(const ASTNode& node, size_t depth) { pending.push_back({ &node, {}, 0, depth }); }
+        void pushText(std::string_view text, size_t spaces = 0) { pending.push_back({ nullptr, text, spaces, 0 }); }
+
+        void write(std::string_view text);
+        void writeSpaces(size_t count);
+
+        std::string buffer;   // used when printing to a stream
+        std::string* out;
+        std::ostream* stream;
+        PrintOptions options;
+        size_t depth = 0;     // current block nesting
+        size_t recursion = 0; // current visit() nesting
+        std::vector<Item> pending; // printIterative() work, reused between calls
+    }; // class Printer
+
+    // Append the printed form of node to out
+    void print(const ASTNode& node, std::string& out, PrintOptions options = {});
+
+    // Stream the printed form of node
+    void print(const ASTNode& node, std::ostream& stream, PrintOptions options = {});
+    std::ostream& operator<<(std::ostream& stream, const ASTNode& node);
+
+    std::string toString(const ASTNode& node, PrintOptions options = {});
+
+} // namespace AST
\ No newline at end of file
@@ -0,0 +1,323 @@
+// Scanner.cpp
+// Vectorized byte scanning for the tokenizer. Every routine has a scalar
+// version that defines the result; the SSE2/AVX2 versions process 16/32
+// bytes per step and fall back to the scalar loop for the tail.
+#include "Scanner.h"
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define NAVO_SCAN_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define NAVO_TARGET_AVX2
+#else
+#define NAVO_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace Lexer {
+
+    namespace {
+
+        enum class ScanKind {
+            Whitespace,
+            Identifier,
+            Digits,
+            StringBody,
+            LineBody,
+            CommentStar
+        };
+
+        // True for the byte that ends a scan of the given kind
+        template <ScanKind Kind>
+        inline bool isStop(char ch) {
+            if constexpr (Kind == ScanKind::Whitespace) return !isSpaceByte(ch);
+            if constexpr (Kind == ScanKind::Identifier) return !isIdentifierByte(ch);
+            if constexpr (Kind == ScanKind::Digits) return !isDigitByte(ch);
+            if constexpr (Kind == ScanKind::StringBody) return ch == '"' || ch == '\\';
+            if constexpr (Kind == ScanKind::LineBody) return ch == '\n';
+            if constexpr (Kind == ScanKind::CommentStar) return ch == '*';
+        }
+
+        template <ScanKind Kind>
+        size_t scanScalar(const char* data, size_t pos, size_t length) {
+            while (pos < length && !isStop<Kind>(data[pos])) {
+                pos++;
+            }
+            return pos;
+        }
+
+#ifdef NAVO_SCAN_X86
+
+        // Most runs (a single space, a short name) end within a few bytes;
+        // check those one at a time before paying for vector loads.
+        constexpr size_t ShortRun = 8;
+
+        // Returns true and leaves pos on the stop byte if the run ends early
+        template <ScanKind Kind>
+        inline bool scanShortRun(const char* data, size_t& pos, size_t length) {
+            size_t limit = (length - pos > ShortRun) ? pos + ShortRun : length;
+            for (; pos < limit; pos++) {
+                if (isStop<Kind>(data[pos])) {
+                    return true;
+                }
+            }
+            return pos == length;
+        }
+
+        inline unsigned countTrailingZeros(unsigned mask) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+        // === SSE2 ===
+
+        // Bytes in [lo, hi] (unsigned)
+        inline __m128i inRange16(__m128i v, char lo, char hi) {
+            __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+            __m128i clamped = _mm_min_epu8(shifted, _mm_set1_epi8(static_cast<char>(hi - lo)));
+            return _mm_cmpeq_epi8(shifted, clamped);
+        }
+
+        template <ScanKind Kind>
+        inline unsigned stopMask16(__m128i v) {
+            if constexpr (Kind == ScanKind::Whitespace) {
+                __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), inRange16(v, '\t', '\r'));
+                return ~static_cast<unsigned>(_mm_movemask_epi8(space)) & 0xFFFFu;
+            }
+            if constexpr (Kind == ScanKind::Identifier) {
+                __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+                __m128i ident = _mm_or_si128(
+                    _mm_or_si128(inRange16(lower, 'a', 'z'), inRange16(v, '0', '9')),
+                    _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+                return ~static_cast<unsigned>(_mm_movemask_epi8(ident)) & 0xFFFFu;
+            }
+            if constexpr (Kind == ScanKind::Digits) {
+                return ~static_cast<unsigned>(_mm_movemask_epi8(inRange16(v, '0', '9'))) & 0xFFFFu;
+            }
+            if constexpr (Kind == ScanKind::StringBody) {
+                __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+                return static_cast<unsigned>(_mm_movemask_epi8(stop));
+            }
+            if constexpr (Kind == ScanKind::LineBody) {
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+            }
+            if constexpr (Kind == ScanKind::CommentStar) {
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('*'))));
+            }
+        }
+
+        template <ScanKind Kind>
+        size_t scanSse2(const char* data, size_t pos, size_t length) {
+            if (scanShortRun<Kind>(data, pos, length)) {
+                return pos;
+            }
+            for (; pos + 16 <= length; pos += 16) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+                unsigned stop = stopMask16<Kind>(v);
+                if (stop != 0) {
+                    return pos + countTrailingZeros(stop);
+                }
+            }
+            return scanScalar<Kind>(data, pos, length);
+        }
+
+        // === AVX2 ===
+
+        NAVO_TARGET_AVX2 inline __m256i inRange32(__m256i v, char lo, char hi) {
+            __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+            __m256i clamped = _mm256_min_epu8(shifted, _mm256_set1_epi8(static_cast<char>(hi - lo)));
+            return _mm256_cmpeq_epi8(shifted, clamped);
+        }
+
+        template <ScanKind Kind>
+        NAVO_TARGET_AVX2 inline unsigned stopMask32(__m256i v) {
+            if constexpr (Kind == ScanKind::Whitespace) {
+                __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), inRange32(v, '\t', '\r'));
+                return ~static_cast<unsigned>(_mm256_movemask_epi8(space));
+            }
+            if constexpr (Kind == ScanKind::Identifier) {
+                __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+                __m256i ident = _mm256_or_si256(
+                    _mm256_or_si256(inRange32(lower, 'a', 'z'), inRange32(v, '0', '9')),
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+                return ~static_cast<unsigned>(_mm256_movemask_epi8(ident));
+            }
+            if constexpr (Kind == ScanKind::Digits) {
+                return ~static_cast<unsigned>(_mm256_movemask_epi8(inRange32(v, '0', '9')));
+            }
+            if constexpr (Kind == ScanKind::StringBody) {
+                __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+                return static_cast<unsigned>(_mm256_movemask_epi8(stop));
+            }
+            if constexpr (Kind == ScanKind::LineBody) {
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+            }
+            if constexpr (Kind == ScanKind::CommentStar) {
+                return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('*'))));
+            }
+        }
+
+        template <ScanKind Kind>
+        NAVO_TARGET_AVX2 size_t scanAvx2(const char* data, size_t pos, size_t length) {
+            if (scanShortRun<Kind>(data, pos, length)) {
+                return pos;
+            }
+            for (; pos + 32 <= length; pos += 32) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+                unsigned stop = stopMask32<Kind>(v);
+                if (stop != 0) {
+                    return pos + countTrailingZeros(stop);
+                }
+            }
+            // Finish with one SSE2 step before the scalar tail
+            return scanSse2<Kind>(data, pos, length);
+        }
+
+        bool cpuSupportsAvx2() {
+#ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            bool avx = (info[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+                return false; // OS does not preserve YMM registers
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+
+#endif // NAVO_SCAN_X86
+
+        using ScanFunction = size_t(*)(const char*, size_t, size_t);
+
+        struct ScanTable {
+            ScanLevel level;
+            ScanFunction whitespace;
+            ScanFunction identifier;
+            ScanFunction digits;
+            ScanFunction stringBody;
+            ScanFunction lineBody;
+            ScanFunction commentStar;
+        };
+
+        const ScanTable scalarTable{ ScanLevel::Scalar,
+            scanScalar<ScanKind::Whitespace>, scanScalar<ScanKind::Identifier>,
+            scanScalar<ScanKind::Digits>, scanScalar<ScanKind::StringBody>,
+            scanScalar<ScanKind::LineBody>, scanScalar<ScanKind::CommentStar> };
+
+#ifdef NAVO_SCAN_X86
+        const ScanTable sse2Table{ ScanLevel::SSE2,
+            scanSse2<ScanKind::Whitespace>, scanSse2<ScanKind::Identifier>,
+            scanSse2<ScanKind::Digits>, scanSse2<ScanKind::StringBody>,
+            scanSse2<ScanKind::LineBody>, scanSse2<ScanKind::CommentStar> };
+
+        const ScanTable avx2Table{ ScanLevel::AVX2,
+            scanAvx2<ScanKind::Whitespace>, scanAvx2<ScanKind::Identifier>,
+            scanAvx2<ScanKind::Digits>, scanAvx2<ScanKind::StringBody>,
+            scanAvx2<ScanKind::LineBody>, scanAvx2<ScanKind::CommentStar> };
+#endif
+
+        const ScanTable* tableFor(ScanLevel level) {
+#ifdef NAVO_SCAN_X86
+            switch (level) {
+            case ScanLevel::AVX2: return &avx2Table;
+            case ScanLevel::SSE2: return &sse2Table;
+            default:              return &scalarTable;
+            }
+#else
+            (void)level;
+            return &scalarTable;
+#endif
+        }
+
+        std::atomic<const ScanTable*>& activeTable() {
+            static std::atomic<const ScanTable*> table{ tableFor(detectScanLevel()) };
+            return table;
+        }
+
+        inline const ScanTable& table() {
+            return *activeTable().load(std::memory_order_relaxed);
+        }
+
+    } // namespace
+
+    ScanLevel detectScanLevel() {
+#ifdef NAVO_SCAN_X86
+        static const ScanLevel best = cpuSupportsAvx2() ? ScanLevel::AVX2 : ScanLevel::SSE2;
+        return best;
+#else
+        return ScanLevel::Scalar;
+#endif
+    }
+
+    ScanLevel scanLevel() {
+        return table().level;
+    }
+
+    ScanLevel setScanLevel(ScanLevel level) {
+        if (static_cast<int>(level) > static_cast<int>(detectScanLevel())) {
+            level = detectScanLevel();
+        }
+        activeTable().store(tableFor(level), std::memory_order_relaxed);
+        return level;
+    }
+
+    const char* scanLevelToString(ScanLevel level) {
+        switch (level) {
+        case ScanLevel::Scalar: return "Scalar";
+        case ScanLevel::SSE2:   return "SSE2";
+        case ScanLevel::AVX2:   return "AVX2";
+        default:                return "Invalid";
+        }
+    }
+
+    size_t skipWhitespace(std::string_view input, size_t pos) {
+        return table().whitespace(input.data(), pos, input.size());
+    }
+
+    size_t skipIdentifier(std::string_view input, size_t pos) {
+        return table().identifier(input.data(), pos, input.size());
+    }
+
+    size_t skipDigits(std::string_view input, size_t pos) {
+        return table().digits(input.data(), pos, input.size());
+    }
+
+    size_t findStringDelimiter(std::string_view input, size_t pos) {
+        return table().stringBody(input.data(), pos, input.size());
+    }
+
+    size_t findLineEnd(std::string_view input, size_t pos) {
+        return table().lineBody(input.data(), pos, input.size());
+    }
+
+    size_t findBlockCommentEnd(std::string_view input, size_t pos) {
+        const auto& scan = table();
+        while (true) {
+            pos = scan.commentStar(input.data(), pos, input.size());
+            if (pos + 1 >= input.size()) {
+                return input.size();
+            }
+            if (input[pos + 1] == '/') {
+                return pos;
+            }
+            pos++;
+        }
+    }
+
+} // namespace Lexer
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+namespace Lexer {
+
+    // Byte classes used by the tokenizer. These match the "C" locale
+    // classification of std::isspace/std::isalnum/std::isdigit but never
+    // consult the locale and are safe for bytes >= 0x80.
+    inline bool isSpaceByte(char ch) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+    }
+
+    inline bool isDigitByte(char ch) {
+        return static_cast<unsigned char>(ch - '0') < 10;
+    }
+
+    inline bool isAlphaByte(char ch) {
+        return static_cast<unsigned char>((ch | 0x20) - 'a') < 26;
+    }
+
+    inline bool isIdentifierStart(char ch) {
+        return isAlphaByte(ch) || ch == '_';
+    }
+
+    inline bool isIdentifierByte(char ch) {
+        return isAlphaByte(ch) || isDigitByte(ch) || ch == '_';
+    }
+
+    // Instruction set used by the scanning functions below
+    enum class ScanLevel {
+        Scalar,
+        SSE2,
+        AVX2
+    }; // enum ScanLevel
+
+    // Best level supported by this build and CPU
+    ScanLevel detectScanLevel();
+
+    // Level currently in use (defaults to detectScanLevel())
+    ScanLevel scanLevel();
+
+    // Force a level, e.g. for benchmarks; clamped to what the CPU supports.
+    // Returns the level actually selected.
+    ScanLevel setScanLevel(ScanLevel level);
+
+    const char* scanLevelToString(ScanLevel level);
+
+    // Bulk scanners. Each starts at pos and returns the position of the first
+    // byte that stops the scan, or input.size() if none does.
+    size_t skipWhitespace(std::string_view input, size_t pos);      // first non-space byte
+    size_t skipIdentifier(std::string_view input, size_t pos);      // first byte outside [A-Za-z0-9_]
+    size_t skipDigits(std::string_view input, size_t pos);          // first non-digit byte
+    size_t findStringDelimiter(std::string_view input, size_t pos); // next '"' or '\\'
+    size_t findLineEnd(std::string_view input, size_t pos);         // next '\n'
+    size_t findBlockCommentEnd(std::string_view input, size_t pos); // start of the next "*/"
+
+} // namespace Lexer
@@ -1,6 +1,8 @@
 ﻿#include "Tokenizer.h"
+#include "TokenSource.h"
 #include "ExpressionParser.h"
 #include "StatementParser.h"
+#include "ParseCache.h"
 #include <iostream>
 #include <string>
 
@@ -13,6 +15,7 @@ void printWelcome() {
     std::cout << "Interactive parser for programming languages" << std::endl;
     std::cout << "Enter code to parse, or 'help' for examples" << std::endl;
     std::cout << "Type 'mode expr' or 'mode stmt' to switch modes" << std::endl;
+    std::cout << "Type 'cache' for parse cache statistics" << std::endl;
     std::cout << "Type 'quit' or 'exit' to quit" << std::endl;
     std::cout << "=====================================" << std::endl;
 }
@@ -50,7 +53,7 @@ void printTokens(const std::vector<Token>& tokens) {
     for (size_t i = 0; i < tokens.size(); ++i) {
         std::cout << "[" << (i + 1) << "] "
             << tokenTypeToString(tokens[i].type)
-            << ": \"" << tokens[i].value << "\"" << std::endl;
+            << ": \"" << tokens[i].text() << "\"" << std::endl;
     }
     std::cout << "-----------------------------------" << std::endl;
 }
@@ -70,6 +73,7 @@ int main() {
 
     std::string input;
     bool statementMode = false; // Default to expression mode
+    Parser::ParseCache cache;   // repeated lines are parsed once
 
     while (true) {
         std::string modeIndicator = statementMode ? "[STMT]" : "[EXPR]";
@@ -115,6 +119,14 @@ int main() {
             continue;
         }
 
+        if (input == "cache") {
+            Parser::ParseCacheStats stats = cache.stats();
+            std::cout << "Parse cache: " << cache.size() << "/" << cache.capacity() << " entries, "
+                << stats.hits << " hits, " << stats.misses << " misses, "
+                << stats.evictions << " evictions" << std::endl;
+            continue;
+        }
+
         if (input == "clear" || input == "cls") {
             system("cls");  // Windows
             system("clear"); // Unix/Linux (one will work, other will be ignored)
@@ -127,8 +139,13 @@ int main() {
             std::cout << "> ";
             if (std::getline(std::cin, input)) {
                 try {
-                    auto tokens = tokenize(input);
+                    std::vector<Trivia> comments;
+                    auto tokens = tokenize(input, comments);
                     printTokens(tokens);
+                    for (const auto& comment : comments) {
+                        std::cout << "Comment before token [" << (comment.token + 1) << "]: \""
+                            << comment.text(input) << "\"" << std::endl;
+                    }
                 }
                 catch (const std::exception& e) {
                     std::cout << "❌ Tokenization Error: " << e.what() << std::endl;
@@ -148,31 +165,20 @@ int main() {
             std::cout << "Auto-detected statement mode for this input." << std::endl;
         }
 
-        // Tokenize and parse the input
-        try {
-            auto tokens = tokenize(input);
-
-            if (useStatementMode) {
-                // Parse as statement
-                Parser::StatementParser statementParser(tokens);
-                auto ast = statementParser.parse();
-
-                std::cout << "✅ Statement parsed successfully:" << std::endl;
-                std::cout << "AST: " << ast->toString() << std::endl;
-            }
-            else {
-                // Parse as expression
-                Parser::ExpressionParser expressionParser(tokens);
-                auto ast = expressionParser.parse();
-
-                std::cout << "✅ Expression parsed successfully:" << std::endl;
-                std::cout << "AST: " << ast->toString() << std::endl;
-            }
-        }
-        catch (const std::exception& e) {
-            std::cout << "❌ Parse Error: " << e.what() << std::endl;
+        // Tokenize lazily while parsing the input, or reuse an earlier parse of it
+        auto parsed = cache.parse(input, useStatementMode ? Parser::ParseMode::Statement : Parser::ParseMode::Expression);
+        if (!parsed->ok()) {
+            std::cout << "❌ Parse Error: " << parsed->error().message() << std::endl;
             std::cout << "💡 Try switching modes with 'mode expr' or 'mode stmt'" << std::endl;
         }
+        else if (useStatementMode) {
+            std::cout << "✅ Statement parsed successfully:" << std::endl;
+            std::cout << "AST: " << parsed->statement(0).toString() << std::endl;
+        }
+        else {
+            std::cout << "✅ Expression parsed successfully:" << std::endl;
+            std::cout << "AST: " << parsed->expression().toString() << std::endl;
+        }
     }
 
     return 0;
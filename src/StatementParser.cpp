@@ -3,197 +3,140 @@
 
 namespace Parser {
 
-    StatementParser::StatementParser(const std::vector<Lexer::Token>& tokens)
-        : tokens(tokens), current(0) {
+    template <class Builder>
+    BasicStatementParser<Builder>::BasicStatementParser(const std::vector<Lexer::Token>& tokens, Builder builder)
+        : Base(tokens, std::move(builder)) {
     }
 
-    bool StatementParser::isAtEnd() const {
-        return current >= tokens.size();
+    template <class Builder>
+    BasicStatementParser<Builder>::BasicStatementParser(std::vector<Lexer::Token>&& tokens, Builder builder)
+        : Base(std::move(tokens), std::move(builder)) {
     }
 
-    Lexer::Token StatementParser::peek() const {
-        if (isAtEnd()) {
-            return Lexer::Token(Lexer::TokenType::Unknown, "");
-        }
-        return tokens[current];
-    }
-
-    Lexer::Token StatementParser::previous() const {
-        if (current == 0) {
-            return Lexer::Token(Lexer::TokenType::Unknown, "");
-        }
-        return tokens[current - 1];
+    template <class Builder>
+    BasicStatementParser<Builder>::BasicStatementParser(Lexer::TokenSource& source, Builder builder)
+        : Base(source, std::move(builder)) {
     }
 
-    bool StatementParser::check(Lexer::TokenType type) const {
-        if (isAtEnd()) return false;
-        return peek().type == type;
-    }
-
-    bool StatementParser::match(const std::string& value) {
-        if (!isAtEnd() && peek().value == value) {
+    template <class Builder>
+    bool BasicStatementParser<Builder>::consume(Lexer::TokenType type, const char* message) {
+        if (check(type)) {
             advance();
             return true;
         }
-        return false;
-    }
 
-    bool StatementParser::matchKeyword(const std::string& keyword) {
-        if (!isAtEnd() && peek().type == Lexer::TokenType::Keyword && peek().value == keyword) {
-            advance();
-            return true;
-        }
+        fail(Lexer::ErrorCode::ExpectedTokenType, message, static_cast<std::uint64_t>(peek().type));
         return false;
     }
 
-    Lexer::Token StatementParser::advance() {
-        if (!isAtEnd()) current++;
-        return previous();
-    }
-
-    Lexer::Token StatementParser::consume(Lexer::TokenType type, const std::string& message) {
-        if (check(type)) {
-            return advance();
+    // Helper: consume a token of a specific kind
+    template <class Builder>
+    bool BasicStatementParser<Builder>::expect(Lexer::TokenKind kind, const char* message) {
+        if (match(kind)) {
+            return true;
         }
 
-        std::string error = message + ". Got: ";
-        if (!isAtEnd()) {
-            error += "'" + peek().value + "' (type: " + std::to_string(static_cast<int>(peek().type)) + ")";
-        }
-        else {
-            error += "end of input";
-        }
-        throw std::runtime_error(error);
+        fail(Lexer::ErrorCode::ExpectedToken, message);
+        return false;
     }
 
-    // Helper: consume a specific token value
-    void StatementParser::expect(const std::string& value, const std::string& message) {
-        if (match(value)) {
-            return;
+    // Parse a full expression directly on the shared token cursor. The
+    // expression grammar stops at the first token that cannot continue the
+    // expression (';', ')', '{', a statement keyword, ...), which the
+    // statement rule then checks.
+    template <class Builder>
+    auto BasicStatementParser<Builder>::parseExpression() -> Expression {
+        if (isAtEnd()) {
+            fail(Lexer::ErrorCode::Expected, "Expected expression");
+            return builder.emptyExpression();
         }
 
-        std::string error = message + ". Got: ";
-        if (!isAtEnd()) {
-            error += "'" + peek().value + "'";
-        }
-        else {
-            error += "end of input";
-        }
-        throw std::runtime_error(error);
+        return expression();
     }
 
-    // Parse a full expression by delegating to ExpressionParser
-    AST::ExpressionPtr StatementParser::parseExpression() {
-        if (isAtEnd()) {
-            throw std::runtime_error("Expected expression");
+    // Main statement dispatcher
+    template <class Builder>
+    auto BasicStatementParser<Builder>::statement() -> Statement {
+        if (options.explicitStack) {
+            return statementIterative();
         }
 
-        // Collect all tokens until we hit a terminator
-        std::vector<Lexer::Token> exprTokens;
-        int depth = 0; // Track parentheses depth
-
-        while (!isAtEnd()) {
-            const auto& token = peek();
-
-            // Handle parentheses depth
-            if (token.value == "(") {
-                depth++;
-            }
-            else if (token.value == ")") {
-                if (depth == 0) {
-                    // This closing paren is not part of our expression
-                    break;
-                }
-                depth--;
-            }
-
-            // Terminators (only when not inside parentheses)
-            if (depth == 0) {
-                if (token.value == ";" || token.value == "{" || token.value == "}") {
-                    break;
-                }
-
-                // Non-expression keywords terminate
-                if (token.type == Lexer::TokenType::Keyword) {
-                    if (token.value != "true" && token.value != "false" &&
-                        token.value != "not" && token.value != "and" && token.value != "or") {
-                        break;
-                    }
-                }
-            }
+        switch (peek().kind) {
+        case Lexer::TokenKind::KwIf:
+            return ifStatement();
 
-            exprTokens.push_back(token);
-            advance();
-        }
+        // Blocks
+        case Lexer::TokenKind::LeftBrace:
+            return block();
 
-        if (exprTokens.empty()) {
-            throw std::runtime_error("Expected expression");
+        default:
+            return simpleStatement();
         }
-
-        // Use ExpressionParser to parse the collected tokens
-        ExpressionParser parser(exprTokens);
-        return parser.parse();
     }
 
-    // Main statement dispatcher
-    AST::StatementPtr StatementParser::statement() {
+    // Statements that do not nest other statements
+    template <class Builder>
+    auto BasicStatementParser<Builder>::simpleStatement() -> Statement {
+        switch (peek().kind) {
         // Variable declarations
-        if (check(Lexer::TokenType::Keyword)) {
-            const auto& kw = peek().value;
-            if (kw == "number" || kw == "word" || kw == "boolean") {
-                return variableDeclaration();
-            }
-            if (kw == "if") {
-                return ifStatement();
-            }
-        }
-
-        // Blocks
-        if (peek().value == "{") {
-            return block();
-        }
+        case Lexer::TokenKind::KwNumber:
+        case Lexer::TokenKind::KwWord:
+        case Lexer::TokenKind::KwBoolean:
+            return variableDeclaration();
 
         // Assignment or expression statement
-        return assignmentOrExpressionStatement();
+        default:
+            return assignmentOrExpressionStatement();
+        }
     }
 
     // VariableDeclaration ::= Type Identifier ['=' Expression] ';'
-    AST::StatementPtr StatementParser::variableDeclaration() {
+    template <class Builder>
+    auto BasicStatementParser<Builder>::variableDeclaration() -> Statement {
         // Type keyword
-        auto typeToken = consume(Lexer::TokenType::Keyword, "Expected type keyword");
-        std::string type = typeToken.value;
+        if (!consume(Lexer::TokenType::Keyword, "Expected type keyword")) {
+            return builder.emptyStatement();
+        }
+        std::string type(previous().text());
 
         // Identifier
-        auto nameToken = consume(Lexer::TokenType::Identifier, "Expected variable name");
-        std::string name = nameToken.value;
+        if (!consume(Lexer::TokenType::Identifier, "Expected variable name")) {
+            return builder.emptyStatement();
+        }
+        Lexer::Symbol name = previous().symbol;
 
         // Optional initializer
-        AST::ExpressionPtr initializer = nullptr;
-        if (match("=")) {
+        Expression initializer = builder.emptyExpression();
+        if (match(Lexer::TokenKind::Assign)) {
             initializer = parseExpression();
         }
 
         // Semicolon
-        expect(";", "Expected ';' after variable declaration");
+        if (failed() || !expect(Lexer::TokenKind::Semicolon, "Expected ';' after variable declaration")) {
+            return builder.emptyStatement();
+        }
 
-        return AST::makeVariableDeclaration(type, name, std::move(initializer));
+        return builder.variableDeclaration(type, name, std::move(initializer));
     }
 
     // Determine if this is assignment or expression statement
-    AST::StatementPtr StatementParser::assignmentOrExpressionStatement() {
+    template <class Builder>
+    auto BasicStatementParser<Builder>::assignmentOrExpressionStatement() -> Statement {
         // Look ahead: if we have identifier followed by '=', it's assignment
-        if (current < tokens.size() &&
-            tokens[current].type == Lexer::TokenType::Identifier &&
-            current + 1 < tokens.size() &&
-            tokens[current + 1].value == "=") {
+        if (peek().type == Lexer::TokenType::Identifier &&
+            peek(1).kind == Lexer::TokenKind::Assign) {
 
             // Assignment
-            std::string varName = advance().value;
-            expect("=", "Expected '=' in assignment");
+            Lexer::Symbol varName = advance().symbol;
+            if (!expect(Lexer::TokenKind::Assign, "Expected '=' in assignment")) {
+                return builder.emptyStatement();
+            }
             auto value = parseExpression();
-            expect(";", "Expected ';' after assignment");
+            if (failed() || !expect(Lexer::TokenKind::Semicolon, "Expected ';' after assignment")) {
+                return builder.emptyStatement();
+            }
 
-            return AST::makeAssignment(varName, std::move(value));
+            return builder.assignment(varName, std::move(value));
         }
 
         // Expression statement
@@ -201,67 +144,417 @@ namespace Parser {
     }
 
     // ExpressionStatement ::= Expression ';'
-    AST::StatementPtr StatementParser::expressionStatement() {
+    template <class Builder>
+    auto BasicStatementParser<Builder>::expressionStatement() -> Statement {
         auto expr = parseExpression();
-        expect(";", "Expected ';' after expression");
-        return AST::makeExpressionStatement(std::move(expr));
+        if (failed() || !expect(Lexer::TokenKind::Semicolon, "Expected ';' after expression")) {
+            return builder.emptyStatement();
+        }
+        return builder.expressionStatement(std::move(expr));
     }
 
     // IfStatement ::= 'if' '(' Expression ')' Statement ['else' Statement]
-    AST::StatementPtr StatementParser::ifStatement() {
-        if (!matchKeyword("if")) {
-            throw std::runtime_error("Expected 'if'");
+    template <class Builder>
+    auto BasicStatementParser<Builder>::ifStatement() -> Statement {
+        if (!match(Lexer::TokenKind::KwIf)) {
+            fail(Lexer::ErrorCode::Expected, "Expected 'if'");
+            return builder.emptyStatement();
         }
 
-        expect("(", "Expected '(' after 'if'");
+        if (!expect(Lexer::TokenKind::LeftParen, "Expected '(' after 'if'")) {
+            return builder.emptyStatement();
+        }
         auto condition = parseExpression();
-        expect(")", "Expected ')' after if condition");
+        if (failed() || !expect(Lexer::TokenKind::RightParen, "Expected ')' after if condition")) {
+            return builder.emptyStatement();
+        }
 
+        Nesting nesting(*this);
+        if (!nesting) {
+            return builder.emptyStatement();
+        }
         auto thenStatement = statement();
+        if (failed()) {
+            return builder.emptyStatement();
+        }
 
-        AST::StatementPtr elseStatement = nullptr;
-        if (matchKeyword("else")) {
+        Statement elseStatement = builder.emptyStatement();
+        if (match(Lexer::TokenKind::KwElse)) {
             elseStatement = statement();
+            if (failed()) {
+                return builder.emptyStatement();
+            }
         }
 
-        return AST::makeIf(std::move(condition), std::move(thenStatement), std::move(elseStatement));
+        return builder.ifStatement(std::move(condition), std::move(thenStatement), std::move(elseStatement));
     }
 
     // Block ::= '{' Statement* '}'
-    AST::StatementPtr StatementParser::block() {
-        expect("{", "Expected '{'");
+    template <class Builder>
+    auto BasicStatementParser<Builder>::block() -> Statement {
+        if (!expect(Lexer::TokenKind::LeftBrace, "Expected '{'")) {
+            return builder.emptyStatement();
+        }
+        Nesting nesting(*this);
+        if (!nesting) {
+            return builder.emptyStatement();
+        }
+        if (lazyBlocks()) {
+            return lazyBlock();
+        }
+
+        std::vector<Statement> statements;
 
-        std::vector<AST::StatementPtr> statements;
+        while (!isAtEnd() && peek().kind != Lexer::TokenKind::RightBrace) {
+            auto stmt = statement();
+            if (failed()) {
+                if (!recovering) {
+                    return builder.emptyStatement();
+                }
+                recover(true);
+                continue;
+            }
+            statements.push_back(std::move(stmt));
+        }
 
-        while (!isAtEnd() && peek().value != "}") {
-            statements.push_back(statement());
+        if (!expect(Lexer::TokenKind::RightBrace, "Expected '}' after block")) {
+            return builder.emptyStatement();
         }
 
-        expect("}", "Expected '}' after block");
+        return builder.block(std::move(statements));
+    }
 
-        return AST::makeBlock(std::move(statements));
+    template <class Builder>
+    bool BasicStatementParser<Builder>::lazyBlocks() const {
+        return Builder::LazyBlocks && options.lazyBlocks && !recovering && ownedTokens.empty() &&
+            !AST::Arena::current() && source->position();
+    }
+
+    // Skip to the matching '}' without building anything
+    template <class Builder>
+    auto BasicStatementParser<Builder>::lazyBlock() -> Statement {
+        if constexpr (Builder::LazyBlocks) {
+            const Lexer::Token* body = source->position();
+            size_t open = 1;
+            while (!isAtEnd()) {
+                Lexer::TokenKind kind = peek().kind;
+                if (kind == Lexer::TokenKind::LeftBrace) {
+                    ++open;
+                }
+                else if (kind == Lexer::TokenKind::RightBrace && --open == 0) {
+                    break;
+                }
+                advance();
+            }
+            size_t count = source->position() - body;
+
+            if (!expect(Lexer::TokenKind::RightBrace, "Expected '}' after block")) {
+                return builder.emptyStatement();
+            }
+            return builder.lazyBlock({ body, count, depth, options.maxDepth, options.explicitStack });
+        }
+        else {
+            return builder.emptyStatement(); // lazyBlocks() is false
+        }
+    }
+
+    // Same grammar as statement() with the recursion through if and block
+    // replaced by a heap stack of open statements. Builds the same tree as the
+    // recursive rules, with the same errors.
+    template <class Builder>
+    auto BasicStatementParser<Builder>::statementIterative() -> Statement {
+        enum class FrameType : std::uint8_t { Block, Then, Else };
+        struct Frame {
+            FrameType type;
+            Expression condition;     // Then, Else
+            Statement thenStatement;  // Else
+            std::vector<Statement> statements; // Block
+        };
+
+        std::vector<Frame> frames;
+        typename Base::DepthRestore restore(*this);
+
+        // While recovering, an error drops the statement being built (every
+        // frame above the innermost open block, or that block itself when it
+        // fails to close) and parsing continues inside that block, as block()
+        // does. False when there is no enclosing block to continue in.
+        auto recoverInBlock = [&](bool blockFailed) {
+            if (!recovering) {
+                return false;
+            }
+            if (blockFailed) {
+                frames.pop_back();
+                --depth;
+            }
+            while (!frames.empty() && frames.back().type != FrameType::Block) {
+                frames.pop_back();
+                --depth;
+            }
+            if (frames.empty()) {
+                return false;
+            }
+            recover(true);
+            return true;
+        };
+
+        while (true) {
+            // Open nested statements until a simple one is parsed
+            Statement result = builder.emptyStatement();
+            bool haveResult = false;
+
+            switch (peek().kind) {
+            case Lexer::TokenKind::KwIf: {
+                advance();
+                if (!expect(Lexer::TokenKind::LeftParen, "Expected '(' after 'if'")) {
+                    break;
+                }
+                auto condition = parseExpression();
+                if (failed() || !expect(Lexer::TokenKind::RightParen, "Expected ')' after if condition") || !enterNesting()) {
+                    break;
+                }
+                frames.push_back({ FrameType::Then, std::move(condition), builder.emptyStatement(), {} });
+                break;
+            }
+
+            case Lexer::TokenKind::LeftBrace:
+                advance();
+                if (!enterNesting()) {
+                    break;
+                }
+                if (lazyBlocks()) {
+                    result = lazyBlock();
+                    --depth;
+                    haveResult = !failed();
+                    break;
+                }
+                frames.push_back({ FrameType::Block, builder.emptyExpression(), builder.emptyStatement(), {} });
+                break;
+
+            default:
+                result = simpleStatement();
+                haveResult = !failed();
+                break;
+            }
+
+            if (failed() && !recoverInBlock(false)) {
+                return builder.emptyStatement();
+            }
+
+            // Hand finished statements to their parents, closing every frame that completes
+            while (true) {
+                if (!haveResult) {
+                    Frame& top = frames.back();
+                    if (top.type != FrameType::Block || (!isAtEnd() && peek().kind != Lexer::TokenKind::RightBrace)) {
+                        break; // the top frame needs another statement
+                    }
+
+                    if (!expect(Lexer::TokenKind::RightBrace, "Expected '}' after block")) {
+                        if (!recoverInBlock(true)) {
+                            return builder.emptyStatement();
+                        }
+                        continue;
+                    }
+                    result = builder.block(std::move(top.statements));
+                    frames.pop_back();
+                    --depth;
+                    haveResult = true;
+                    continue;
+                }
+
+                if (frames.empty()) {
+                    return result;
+                }
+
+                Frame& top = frames.back();
+                switch (top.type) {
+                case FrameType::Block:
+                    top.statements.push_back(std::move(result));
+                    haveResult = false;
+                    continue;
+
+                case FrameType::Then:
+                    if (match(Lexer::TokenKind::KwElse)) {
+                        top.thenStatement = std::move(result);
+                        top.type = FrameType::Else;
+                        haveResult = false;
+                        continue;
+                    }
+                    result = builder.ifStatement(std::move(top.condition), std::move(result), builder.emptyStatement());
+                    break;
+
+                case FrameType::Else:
+                    result = builder.ifStatement(std::move(top.condition), std::move(top.thenStatement), std::move(result));
+                    break;
+                }
+                frames.pop_back();
+                --depth;
+            }
+        }
     }
 
     // Parse a single statement from the token stream
-    AST::StatementPtr StatementParser::parse() {
-        auto result = statement();
+    template <class Builder>
+    auto BasicStatementParser<Builder>::tryParse() -> Lexer::Result<Statement> {
+        Lexer::Result<Statement> result;
+        result.value = statement();
 
-        if (!isAtEnd()) {
-            throw std::runtime_error("Unexpected token after statement: '" + peek().value + "'");
+        if (!failed() && !isAtEnd()) {
+            fail(Lexer::ErrorCode::TrailingToken, "statement");
         }
 
+        // The tokens may have run out at a lexical error
+        if (!failed() && source->error()) {
+            error = source->error();
+        }
+
+        if (failed()) {
+            result.value = builder.emptyStatement();
+            result.error = error;
+        }
         return result;
     }
 
     // Parse multiple statements
-    std::vector<AST::StatementPtr> StatementParser::parseStatements() {
-        std::vector<AST::StatementPtr> statements;
+    template <class Builder>
+    auto BasicStatementParser<Builder>::tryParseStatements() -> Lexer::Result<std::vector<Statement>> {
+        Lexer::Result<std::vector<Statement>> result;
+
+        while (!isAtEnd() && !failed()) {
+            result.value.push_back(statement());
+        }
+
+        if (!failed() && source->error()) {
+            error = source->error();
+        }
+
+        if (failed()) {
+            result.value.clear();
+            result.error = error;
+        }
+        return result;
+    }
+
+    // Keep the current error as a diagnostic. An error already reported at the
+    // same place (e.g. end of input seen again by every open block) is dropped.
+    template <class Builder>
+    void BasicStatementParser<Builder>::report() {
+        if (diagnostics.empty() || diagnostics.back().code != error.code || diagnostics.back().offset != error.offset) {
+            diagnostics.push_back(std::move(error));
+        }
+        error = Lexer::Error();
+    }
+
+    // Panic mode: report the error, then skip tokens up to a point where a
+    // statement can start - just after a ';', or before '{' or a keyword that
+    // starts a statement. Inside a block, stop before its '}' so the block
+    // still closes; at the top level a stray '}' is skipped. Every stop token
+    // is consumed by the statement it starts, so recovery always progresses.
+    template <class Builder>
+    void BasicStatementParser<Builder>::recover(bool inBlock) {
+        report();
+
+        while (!isAtEnd()) {
+            switch (peek().kind) {
+            case Lexer::TokenKind::Semicolon:
+                advance();
+                return;
+
+            case Lexer::TokenKind::RightBrace:
+                if (!inBlock) {
+                    advance();
+                }
+                return;
+
+            case Lexer::TokenKind::LeftBrace:
+            case Lexer::TokenKind::KwIf:
+            case Lexer::TokenKind::KwNumber:
+            case Lexer::TokenKind::KwWord:
+            case Lexer::TokenKind::KwBoolean:
+                return;
+
+            default:
+                advance();
+                break;
+            }
+        }
+    }
+
+    template <class Builder>
+    auto BasicStatementParser<Builder>::parseProgram() -> Program<Statement> {
+        Program<Statement> program;
+        recovering = true;
 
         while (!isAtEnd()) {
-            statements.push_back(statement());
+            auto stmt = statement();
+            if (failed()) {
+                recover(false);
+                continue;
+            }
+            program.statements.push_back(std::move(stmt));
+        }
+
+        // Lexing stops at the first malformed token, which ends the program
+        if (source->error()) {
+            error = source->error();
+            report();
+        }
+
+        recovering = false;
+        program.diagnostics = std::move(diagnostics);
+        diagnostics.clear();
+        return program;
+    }
+
+    template <class Builder>
+    auto BasicStatementParser<Builder>::parse() -> Statement {
+        auto result = tryParse();
+        if (!result) {
+            throw Lexer::SyntaxError(std::move(result.error));
+        }
+        return std::move(result.value);
+    }
+
+    template <class Builder>
+    auto BasicStatementParser<Builder>::parseStatements() -> std::vector<Statement> {
+        auto result = tryParseStatements();
+        if (!result) {
+            throw Lexer::SyntaxError(std::move(result.error));
         }
+        return std::move(result.value);
+    }
+
+    template class BasicStatementParser<AST::TreeBuilder>;
+    template class BasicStatementParser<AST::FlatBuilder>;
+
+} // namespace Parser
 
-        return statements;
+namespace AST {
+
+    // Parsed on the heap, whatever arena the calling thread has active: the
+    // body belongs to this node, not to the caller
+    const Block* LazyBlock::tryBody() const {
+        std::call_once(once, [this]() {
+            HeapScope heap;
+
+            Lexer::VectorTokenSource tokens(source.tokens, source.count);
+            Parser::StatementParser parser(tokens);
+            Parser::ParseOptions options;
+            options.maxDepth = source.maxDepth;
+            options.explicitStack = source.explicitStack;
+            options.lazyBlocks = true;
+            parser.setOptions(options);
+            parser.depth = source.depth;
+
+            auto result = parser.tryParseStatements();
+            if (result) {
+                parsedBody = makeBlock(std::move(result.value));
+            }
+            else {
+                bodyError = std::move(result.error);
+            }
+            done.store(true, std::memory_order_release);
+        });
+        return static_cast<const Block*>(parsedBody.get());
     }
 
-} // namespace Parser
\ No newline at end of file
+} // namespace AST
\ No newline at end of file
@@ -1,47 +1,104 @@
 #pragma once
 #include "Tokenizer.h"
+#include "TokenSource.h"
 #include "AST.h"
 #include "ExpressionParser.h"
+#include <memory>
 #include <vector>
 #include <stdexcept>
 
 namespace Parser {
 
-    class StatementParser {
+    // Result of parsing a whole program with error recovery
+    template <class Statement>
+    struct Program {
+        std::vector<Statement> statements;       // every statement that parsed
+        std::vector<Lexer::Error> diagnostics;   // every error, in source order
+
+        bool ok() const { return diagnostics.empty(); }
+    }; // struct Program
+
+    // Statements are parsed on the same token cursor as the expressions inside
+    // them: the token helpers and the expression grammar are inherited from
+    // the expression parser, so an expression is parsed in place with no pre-scan.
+    template <class Builder>
+    class BasicStatementParser : private BasicExpressionParser<Builder> {
     private:
-        std::vector<Lexer::Token> tokens;
-        size_t current;
-
-        // Helper methods (similar to ExpressionParser)
-        bool isAtEnd() const;
-        Lexer::Token peek() const;
-        Lexer::Token previous() const;
-        bool check(Lexer::TokenType type) const;
-        bool match(const std::string& value);
-        bool matchKeyword(const std::string& keyword);
-        Lexer::Token advance();
-        Lexer::Token consume(Lexer::TokenType type, const std::string& message);
-        void expect(const std::string& value, const std::string& message);
+        using Base = BasicExpressionParser<Builder>;
+        using Expression = typename Builder::Expression;
+        using Statement = typename Builder::Statement;
+
+        using Base::builder;
+        using Base::options;
+        using Base::depth;
+        using Base::enterNesting;
+        using Nesting = typename Base::Nesting;
+        using Base::source;
+        using Base::error;
+        using Base::failed;
+        using Base::fail;
+        using Base::isAtEnd;
+        using Base::peek;
+        using Base::previous;
+        using Base::check;
+        using Base::match;
+        using Base::advance;
+        using Base::expression;
+        using Base::ownedTokens;
+
+        // Helper methods (the rest come from the expression parser)
+        bool consume(Lexer::TokenType type, const char* message);
+        bool expect(Lexer::TokenKind kind, const char* message);
 
         // Grammar rules for statements
-        AST::StatementPtr statement();
-        AST::StatementPtr variableDeclaration();
-        AST::StatementPtr assignmentOrExpressionStatement();
-        AST::StatementPtr ifStatement();
-        AST::StatementPtr block();
-        AST::StatementPtr expressionStatement();
+        Statement statement();
+        Statement simpleStatement();
+        Statement statementIterative(); // statement() on an explicit stack
+        Statement variableDeclaration();
+        Statement assignmentOrExpressionStatement();
+        Statement ifStatement();
+        Statement block();
+        Statement expressionStatement();
+
+        // Lazy blocks (ParseOptions::lazyBlocks): after the '{', match the
+        // braces and keep the body's tokens instead of parsing them
+        bool lazyBlocks() const;
+        Statement lazyBlock();
+        friend class AST::LazyBlock; // parses the body later, at the same depth
 
-        // Helper to parse expressions (delegates to ExpressionParser)
-        AST::ExpressionPtr parseExpression();
+        // Parse an expression in place with the inherited expression grammar
+        Expression parseExpression();
+
+        // Error recovery (parseProgram() only)
+        bool recovering = false;
+        std::vector<Lexer::Error> diagnostics;
+        void report(); // move the current error to diagnostics
+        void recover(bool inBlock); // report, then skip to where a statement can start
 
     public:
-        explicit StatementParser(const std::vector<Lexer::Token>& tokens);
+        explicit BasicStatementParser(const std::vector<Lexer::Token>& tokens, Builder builder = Builder()); // tokens must outlive the parser
+        explicit BasicStatementParser(std::vector<Lexer::Token>&& tokens, Builder builder = Builder());
+        explicit BasicStatementParser(Lexer::TokenSource& source, Builder builder = Builder()); // parse straight from a (lazy) token source
 
-        // Parse a single statement
-        AST::StatementPtr parse();
+        // Parse a single statement (throws Lexer::SyntaxError)
+        Statement parse();
 
         // Parse multiple statements (for blocks or whole programs)
-        std::vector<AST::StatementPtr> parseStatements();
+        std::vector<Statement> parseStatements();
+
+        // The same without exceptions: the first error is returned in the result
+        Lexer::Result<Statement> tryParse();
+        Lexer::Result<std::vector<Statement>> tryParseStatements();
+
+        // Parse a whole program in one pass, reporting every error. A statement
+        // that fails is dropped and recorded in diagnostics, and parsing resumes
+        // at the next statement (blocks keep their other statements).
+        Program<Statement> parseProgram();
+
+        using Base::setOptions;
     };
 
+    using StatementParser = BasicStatementParser<AST::TreeBuilder>;
+    using FlatStatementParser = BasicStatementParser<AST::FlatBuilder>; // emits into a FlatTree
+
 } // namespace Parser
\ No newline at end of file
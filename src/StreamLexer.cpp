@@ -0,0 +1,162 @@
+// StreamLexer.cpp
+#include "StreamLexer.h"
+#include "Scanner.h"
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Lexer {
+
+    StreamLexer::StreamLexer(std::istream& in, size_t chunkSize)
+        : StreamLexer([&in](char* dest, size_t size) -> size_t {
+            in.read(dest, static_cast<std::streamsize>(size));
+            return static_cast<size_t>(in.gcount());
+        }, chunkSize) {
+    }
+
+    StreamLexer::StreamLexer(int fd, size_t chunkSize)
+        : StreamLexer([fd](char* dest, size_t size) -> size_t {
+#ifdef _WIN32
+            int n = _read(fd, dest, static_cast<unsigned int>(size));
+#else
+            auto n = ::read(fd, dest, size);
+#endif
+            if (n < 0) {
+                throw std::runtime_error("Failed to read from file descriptor");
+            }
+            return static_cast<size_t>(n);
+        }, chunkSize) {
+    }
+
+    StreamLexer::StreamLexer(ReadFunction read, size_t chunkSize)
+        : read_(std::move(read)), chunkSize_(std::max<size_t>(chunkSize, 1)) {
+    }
+
+    // Append at least 'minimum' bytes (or whatever is left) to the window.
+    // The lexed prefix is dropped only once new bytes arrived, so the window
+    // moves once per chunk rather than once per token, and a failed refill
+    // leaves positions the caller computed against the window intact.
+    bool StreamLexer::refill(size_t minimum) {
+        if (eof_) {
+            return false;
+        }
+
+        size_t want = std::max(chunkSize_, minimum);
+        size_t oldSize = buffer_.size();
+        buffer_.resize(oldSize + want);
+
+        size_t got = 0;
+        while (got < want) {
+            size_t n = read_(&buffer_[oldSize + got], want - got);
+            if (n == 0) {
+                eof_ = true;
+                break;
+            }
+            got += n;
+        }
+
+        buffer_.resize(oldSize + got);
+        if (got == 0) {
+            return false;
+        }
+        compact();
+        return true;
+    }
+
+    // Drop the already-lexed prefix of the window
+    void StreamLexer::compact() {
+        if (pos_ == 0) {
+            return;
+        }
+        buffer_.erase(0, pos_);
+        consumed_ += pos_;
+        pos_ = 0;
+    }
+
+    // Whether a lexing error at pos_ could be caused by the window ending
+    // in the middle of the token rather than by malformed input
+    bool StreamLexer::mayBeTruncated() const {
+        size_t start = skipWhitespace(buffer_, pos_);
+        if (start >= buffer_.size()) {
+            return false;
+        }
+
+        char ch = buffer_[start];
+        if (ch == '"' || ch == '/') {
+            return true; // string or block comment ran off the window
+        }
+
+        // Number whose decimal point is the last byte of the window
+        size_t end = start;
+        while (end < buffer_.size() && (isDigitByte(buffer_[end]) || buffer_[end] == '.')) {
+            end++;
+        }
+        return end == buffer_.size();
+    }
+
+    bool StreamLexer::tryNext() {
+        while (true) {
+            size_t pos = pos_;
+            PackedToken token{};
+            Error error;
+            bool found = nextToken(buffer_, pos, token, error);
+
+            if (error) {
+                // The token may just be cut off by the window (open string,
+                // open comment, "12." ...); only fail for real at end of input.
+                // Growing by the window size keeps long tokens linear overall.
+                error.offset += consumed_; // before refill() moves the window
+                if (mayBeTruncated() && refill(buffer_.size())) {
+                    continue;
+                }
+                error_ = std::move(error);
+                current_ = PackedToken{ TokenType::Unknown, TokenKind::None, 0, 0 };
+                return false;
+            }
+
+            if (!found) {
+                // Only whitespace left in the window
+                pos_ = buffer_.size();
+                if (refill(0)) {
+                    continue;
+                }
+                current_ = PackedToken{ TokenType::Unknown, TokenKind::None, 0, 0 };
+                return false;
+            }
+
+            // A token touching the end of the window might continue in the
+            // next chunk (identifiers, numbers, "+" vs "+=", line comments)
+            if (pos == buffer_.size() && refill(buffer_.size())) {
+                continue;
+            }
+
+            current_ = token;
+            pos_ = pos;
+            return true;
+        }
+    }
+
+    bool StreamLexer::next() {
+        if (tryNext()) {
+            return true;
+        }
+        if (error_) {
+            throw SyntaxError(error_);
+        }
+        return false;
+    }
+
+    bool StreamLexer::next(Token& token) {
+        if (!next()) {
+            return false;
+        }
+        token.assign(type(), text(), kind(), offset());
+        return true;
+    }
+
+} // namespace Lexer
\ No newline at end of file
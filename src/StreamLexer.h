@@ -0,0 +1,58 @@
+#pragma once
+#include "Tokenizer.h"
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+
+namespace Lexer {
+
+    // Tokenizer that pulls its input in fixed-size chunks and hands out one
+    // token at a time, so memory stays bounded by the chunk size plus the
+    // longest single token regardless of the input size.
+    class StreamLexer {
+    public:
+        static constexpr size_t DefaultChunkSize = 64 * 1024;
+
+        // Reads up to 'size' bytes into 'dest', returns 0 at end of input
+        using ReadFunction = std::function<size_t(char* dest, size_t size)>;
+
+        explicit StreamLexer(std::istream& in, size_t chunkSize = DefaultChunkSize);
+        explicit StreamLexer(int fd, size_t chunkSize = DefaultChunkSize);
+        explicit StreamLexer(ReadFunction read, size_t chunkSize = DefaultChunkSize);
+
+        // Advance to the next token. Returns false once the input is exhausted.
+        // Throws SyntaxError on malformed input.
+        bool next();
+
+        // Convenience overload that copies the current token out
+        bool next(Token& token);
+
+        // next() without exceptions: returns false at the end of input or on a
+        // lexical error, which error() then reports
+        bool tryNext();
+        const Error& error() const { return error_; }
+
+        // Current token; text() is only valid until the next call to next()
+        TokenType type() const { return current_.type; }
+        TokenKind kind() const { return current_.kind; }
+        std::string_view text() const { return current_.text(buffer_); }
+        std::uint64_t offset() const { return consumed_ + current_.offset; }
+
+    private:
+        bool refill(size_t minimum);
+        void compact();
+        bool mayBeTruncated() const;
+
+        ReadFunction read_;
+        size_t chunkSize_;
+        std::string buffer_;       // unconsumed input window
+        size_t pos_ = 0;           // scan position inside buffer_
+        std::uint64_t consumed_ = 0; // bytes discarded from the front of buffer_
+        bool eof_ = false;
+        Error error_;
+        PackedToken current_{ TokenType::Unknown, TokenKind::None, 0, 0 };
+    }; // class StreamLexer
+
+} // namespace Lexer
\ No newline at end of file
@@ -0,0 +1,138 @@
+// Symbol.cpp
+#include "Symbol.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace Lexer {
+
+    namespace {
+
+        // Index of the highest set bit (value > 0)
+        unsigned highestBit(std::uint64_t value) {
+            unsigned bit = 0;
+            while (value >>= 1) {
+                ++bit;
+            }
+            return bit;
+        }
+
+    } // namespace
+
+    Symbol Symbol::intern(std::string_view name) {
+        return SymbolTable::global().intern(name);
+    }
+
+    std::string_view Symbol::text() const {
+        return SymbolTable::global().text(*this);
+    }
+
+    SymbolTable::SymbolTable() : slots(1024) {
+        // Id 0 is the empty name
+        segments[0] = new std::string_view[size_t(1) << FirstSegmentBits];
+    }
+
+    SymbolTable::~SymbolTable() {
+        for (auto& segment : segments) {
+            delete[] segment.load();
+        }
+    }
+
+    SymbolTable& SymbolTable::global() {
+        static SymbolTable table;
+        return table;
+    }
+
+    // FNV-1a; identifiers are short
+    std::uint32_t SymbolTable::hashName(std::string_view name) {
+        std::uint32_t hash = 2166136261u;
+        for (char ch : name) {
+            hash = (hash ^ static_cast<unsigned char>(ch)) * 16777619u;
+        }
+        return hash;
+    }
+
+    std::string_view* SymbolTable::entry(std::uint32_t id) const {
+        std::uint64_t index = std::uint64_t(id) + (std::uint64_t(1) << FirstSegmentBits);
+        unsigned segment = highestBit(index) - FirstSegmentBits;
+        std::uint64_t offset = index - (std::uint64_t(1) << (segment + FirstSegmentBits));
+        return segments[segment].load(std::memory_order_acquire) + offset;
+    }
+
+    Symbol SymbolTable::intern(std::string_view name) {
+        if (name.empty()) {
+            return Symbol();
+        }
+
+        std::uint32_t hash = hashName(name);
+        std::lock_guard<std::mutex> lock(mutex);
+
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots[i];
+            if (slot.id == 0) {
+                break;
+            }
+            if (slot.hash == hash && *entry(slot.id) == name) {
+                return Symbol(slot.id);
+            }
+        }
+
+        if (count == 0xFFFFFFFFu) {
+            throw std::length_error("Symbol table is full");
+        }
+
+        // New name: copy it into the arena and give it the next id
+        std::uint32_t id = count;
+        std::uint64_t index = std::uint64_t(id) + (std::uint64_t(1) << FirstSegmentBits);
+        unsigned segment = highestBit(index) - FirstSegmentBits;
+        if (!segments[segment].load(std::memory_order_relaxed)) {
+            segments[segment].store(new std::string_view[size_t(1) << (segment + FirstSegmentBits)], std::memory_order_release);
+        }
+
+        char* text = static_cast<char*>(chars.allocate(name.size(), 1));
+        std::memcpy(text, name.data(), name.size());
+        *entry(id) = std::string_view(text, name.size());
+        ++count;
+
+        if (count * 2 > slots.size()) {
+            grow();
+        }
+        mask = slots.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            if (slots[i].id == 0) {
+                slots[i] = { hash, id };
+                break;
+            }
+        }
+
+        return Symbol(id);
+    }
+
+    // Double the hash table (called with the mutex held)
+    void SymbolTable::grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+
+        size_t mask = slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.id == 0) {
+                continue;
+            }
+            size_t i = slot.hash & mask;
+            while (slots[i].id != 0) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+    }
+
+    std::string_view SymbolTable::text(Symbol symbol) const {
+        return *entry(symbol.id());
+    }
+
+    size_t SymbolTable::size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return count;
+    }
+
+} // namespace Lexer
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace Lexer {
+
+    // Interned identifier: a 32-bit id into the global SymbolTable.
+    // Equal names always get the same id, so comparing two symbols is one
+    // integer compare. Id 0 is the empty name.
+    class Symbol {
+    public:
+        constexpr Symbol() = default;
+
+        // Symbol for name, adding it to the global table on first use
+        static Symbol intern(std::string_view name);
+
+        std::uint32_t id() const { return id_; }
+        bool empty() const { return id_ == 0; }
+
+        // Name of the symbol (reverse lookup; valid for the life of the process)
+        std::string_view text() const;
+        operator std::string_view() const { return text(); }
+
+        bool operator==(Symbol other) const { return id_ == other.id_; }
+        bool operator!=(Symbol other) const { return id_ != other.id_; }
+
+    private:
+        friend class SymbolTable;
+        explicit constexpr Symbol(std::uint32_t id) : id_(id) {}
+
+        std::uint32_t id_ = 0;
+    }; // class Symbol
+
+    // Hash-consing table of identifier names. Names are copied once into a
+    // monotonic arena and never freed. intern() is serialized by a mutex;
+    // text() takes no lock: names live in segments that never move, and the
+    // segment pointers are published atomically.
+    class SymbolTable {
+    public:
+        SymbolTable();
+        SymbolTable(const SymbolTable&) = delete;
+        SymbolTable& operator=(const SymbolTable&) = delete;
+        ~SymbolTable();
+
+        // The table Symbol::intern() and Symbol::text() use
+        static SymbolTable& global();
+
+        Symbol intern(std::string_view name);
+        std::string_view text(Symbol symbol) const;
+
+        size_t size() const; // distinct names, including the empty one
+
+    private:
+        // Segment k holds ids [2^(k+FirstSegmentBits) - 2^FirstSegmentBits, ...),
+        // doubling in size, so 32 - FirstSegmentBits + 1 segments cover every id
+        static constexpr unsigned FirstSegmentBits = 8;
+        static constexpr size_t SegmentCount = 32 - FirstSegmentBits + 1;
+
+        struct Slot {
+            std::uint32_t hash = 0;
+            std::uint32_t id = 0; // 0 = free
+        };
+
+        static std::uint32_t hashName(std::string_view name);
+        std::string_view* entry(std::uint32_t id) const;
+        void grow();
+
+        mutable std::mutex mutex;
+        std::pmr::monotonic_buffer_resource chars; // name bytes
+        std::vector<Slot> slots;                   // open addressing, power-of-two size
+        std::uint32_t count = 1;                   // next id (0 is taken by the empty name)
+        std::array<std::atomic<std::string_view*>, SegmentCount> segments{};
+    }; // class SymbolTable
+
+} // namespace Lexer
\ No newline at end of file
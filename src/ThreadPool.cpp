@@ -0,0 +1,129 @@
+// ThreadPool.cpp
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace Util {
+
+    ThreadPool::ThreadPool(size_t threads) {
+        if (threads == 0) {
+            threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        for (size_t i = 0; i < threads; ++i) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (size_t i = 1; i < threads; ++i) {
+            workers.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::forEach(size_t count, const std::function<void(size_t)>& job) {
+        if (count == 0) {
+            return;
+        }
+
+        // Publish the job before any index can be taken
+        task.store(&job);
+        remaining.store(count);
+
+        // Deal contiguous runs of indices, so neighbouring jobs start on one thread
+        size_t threads = queues.size();
+        for (size_t t = 0; t < threads; ++t) {
+            std::lock_guard<std::mutex> lock(queues[t]->mutex);
+            for (size_t i = t * count / threads; i < (t + 1) * count / threads; ++i) {
+                queues[t]->items.push_back(i);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++generation;
+        }
+        wake.notify_all();
+
+        runJobs(0);
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this]() { return remaining.load() == 0; });
+            std::swap(error, failure);
+        }
+        task.store(nullptr);
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    void ThreadPool::workerLoop(size_t self) {
+        size_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+            }
+            runJobs(self);
+        }
+    }
+
+    void ThreadPool::runJobs(size_t self) {
+        size_t index;
+        while (take(self, index)) {
+            try {
+                (*task.load())(index);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+            }
+
+            if (remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(mutex);
+                done.notify_all();
+            }
+        }
+    }
+
+    // Own queue from the back, then the others from the front
+    bool ThreadPool::take(size_t self, size_t& index) {
+        {
+            Queue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.items.empty()) {
+                index = own.items.back();
+                own.items.pop_back();
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < queues.size(); ++i) {
+            Queue& victim = *queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.items.empty()) {
+                index = victim.items.front();
+                victim.items.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace Util
\ No newline at end of file
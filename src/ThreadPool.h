@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Util {
+
+    // Fixed set of threads running index-based jobs with work stealing.
+    // forEach() deals the indices out to one queue per thread; each thread
+    // takes from the back of its own queue and, once that is empty, steals
+    // from the front of the others. The calling thread takes part, so a pool
+    // of size 1 runs everything inline.
+    class ThreadPool {
+    public:
+        // threads: how many threads run jobs, the caller included (0 = one per core)
+        explicit ThreadPool(size_t threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t size() const { return queues.size(); }
+
+        // Run task(i) for every i in [0, count) and wait for all of them.
+        // Rethrows the first exception a task threw. Not reentrant: one
+        // forEach() at a time, and tasks must not call it.
+        void forEach(size_t count, const std::function<void(size_t)>& task);
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<size_t> items;
+        };
+
+        void workerLoop(size_t self);
+        void runJobs(size_t self); // until there is nothing left to take
+        bool take(size_t self, size_t& index);
+
+        std::vector<std::unique_ptr<Queue>> queues; // one per thread; 0 is the caller
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable wake; // a new forEach() started, or shutdown
+        std::condition_variable done; // the last job of a forEach() finished
+        size_t generation = 0;
+        bool stopping = false;
+
+        std::atomic<const std::function<void(size_t)>*> task{ nullptr };
+        std::atomic<size_t> remaining{ 0 };
+        std::exception_ptr failure;
+    }; // class ThreadPool
+
+} // namespace Util
\ No newline at end of file
@@ -0,0 +1,162 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Lexer {
+
+    // Specific kind of a token, refining its TokenType
+    enum class TokenKind : std::uint8_t {
+        None, // identifiers, literals, comments
+
+        // Keywords (same order as keywordSpellings)
+        KwIf, KwElse, KwWhile, KwReturn, KwFor, KwFunction, KwNumber, KwWord,
+        KwBoolean, KwTrue, KwFalse, KwNull, KwConst, KwBreak, KwContinue,
+        KwMain, KwPrint, KwInput, KwOr, KwAnd, KwNot, KwDo, KwSwitch,
+        KwCase, KwDefault, KwStruct, KwClass, KwPublic, KwPrivate, KwProtected,
+
+        // Operators (same order as operatorSpellings)
+        Plus, Minus, Star, Slash, Percent, Caret, Assign, Bang, Less, Greater,
+        Amp, Pipe, Tilde,
+        EqualEqual, BangEqual, LessEqual, GreaterEqual, AmpAmp, PipePipe,
+        PlusPlus, MinusMinus, PlusAssign, MinusAssign, StarAssign, SlashAssign,
+        PercentAssign, ShiftLeft, ShiftRight, ShiftLeftAssign, ShiftRightAssign,
+
+        // Punctuation (same order as operatorSpellings)
+        Semicolon, Comma, Dot, Colon, LeftParen, RightParen, LeftBrace, RightBrace,
+        LeftBracket, RightBracket,
+    }; // enum TokenKind
+
+    constexpr TokenKind FirstKeyword = TokenKind::KwIf;
+    constexpr TokenKind LastKeyword = TokenKind::KwProtected;
+
+    inline constexpr std::string_view keywordSpellings[] = {
+        "if", "else", "while", "return", "for", "function", "number", "word",
+        "boolean", "true", "false", "null", "const", "break", "continue",
+        "main", "print", "input", "or", "and", "not", "do", "switch",
+        "case", "default", "struct", "class", "public", "private", "protected"
+    };
+
+    constexpr size_t KeywordCount = sizeof(keywordSpellings) / sizeof(keywordSpellings[0]);
+    static_assert(KeywordCount == static_cast<size_t>(LastKeyword) - static_cast<size_t>(FirstKeyword) + 1,
+        "keywordSpellings and the keyword kinds in TokenKind are out of sync");
+
+    constexpr bool isKeyword(TokenKind kind) {
+        return kind >= FirstKeyword && kind <= LastKeyword;
+    }
+
+    constexpr std::string_view keywordText(TokenKind kind) {
+        return isKeyword(kind)
+            ? keywordSpellings[static_cast<size_t>(kind) - static_cast<size_t>(FirstKeyword)]
+            : std::string_view();
+    }
+
+    constexpr TokenKind FirstOperator = TokenKind::Plus;
+    constexpr TokenKind LastOperator = TokenKind::ShiftRightAssign;
+    constexpr TokenKind FirstPunctuation = TokenKind::Semicolon;
+    constexpr TokenKind LastPunctuation = TokenKind::RightBracket;
+
+    // Spellings of operators followed by punctuation, indexed from FirstOperator
+    inline constexpr std::string_view operatorSpellings[] = {
+        "+", "-", "*", "/", "%", "^", "=", "!", "<", ">",
+        "&", "|", "~",
+        "==", "!=", "<=", ">=", "&&", "||",
+        "++", "--", "+=", "-=", "*=", "/=",
+        "%=", "<<", ">>", "<<=", ">>=",
+        ";", ",", ".", ":", "(", ")", "{", "}",
+        "[", "]"
+    };
+
+    constexpr size_t OperatorCount = sizeof(operatorSpellings) / sizeof(operatorSpellings[0]);
+    static_assert(OperatorCount == static_cast<size_t>(LastPunctuation) - static_cast<size_t>(FirstOperator) + 1,
+        "operatorSpellings and the operator kinds in TokenKind are out of sync");
+
+    constexpr size_t TokenKindCount = static_cast<size_t>(LastPunctuation) + 1;
+
+    constexpr bool isOperator(TokenKind kind) {
+        return kind >= FirstOperator && kind <= LastOperator;
+    }
+
+    constexpr bool isPunctuation(TokenKind kind) {
+        return kind >= FirstPunctuation && kind <= LastPunctuation;
+    }
+
+    // Source spelling of any keyword, operator or punctuation kind
+    constexpr std::string_view tokenKindText(TokenKind kind) {
+        if (isKeyword(kind)) {
+            return keywordText(kind);
+        }
+        if (isOperator(kind) || isPunctuation(kind)) {
+            return operatorSpellings[static_cast<size_t>(kind) - static_cast<size_t>(FirstOperator)];
+        }
+        return std::string_view();
+    }
+
+    // === Perfect hash over the keyword spellings ===
+    // Mixes the length and the first, second and last bytes. The seed was
+    // searched offline; buildKeywordTable() proves at compile time that it
+    // is collision-free for the current keyword list.
+
+    constexpr size_t KeywordTableSize = 64;
+    constexpr std::uint32_t KeywordHashSeed = 273;
+    constexpr size_t MinKeywordLength = 2;
+    constexpr size_t MaxKeywordLength = 9;
+
+    constexpr size_t keywordHash(std::string_view word) {
+        std::uint32_t seed = KeywordHashSeed;
+        std::uint32_t x = static_cast<std::uint32_t>(word.size())
+            + static_cast<unsigned char>(word[0]) * seed
+            + static_cast<unsigned char>(word[1]) * (seed * seed)
+            + static_cast<unsigned char>(word[word.size() - 1]) * (seed * seed * seed);
+        return ((x >> 8) ^ x) % KeywordTableSize;
+    }
+
+    struct KeywordTable {
+        TokenKind slots[KeywordTableSize] = {};
+        bool perfect = true;
+    };
+
+    constexpr KeywordTable buildKeywordTable() {
+        KeywordTable table;
+        for (size_t i = 0; i < KeywordCount; ++i) {
+            std::string_view word = keywordSpellings[i];
+            if (word.size() < MinKeywordLength || word.size() > MaxKeywordLength) {
+                table.perfect = false;
+                continue;
+            }
+            TokenKind& slot = table.slots[keywordHash(word)];
+            if (slot != TokenKind::None) {
+                table.perfect = false; // collision: pick a new seed or table size
+            }
+            slot = static_cast<TokenKind>(static_cast<size_t>(FirstKeyword) + i);
+        }
+        return table;
+    }
+
+    inline constexpr KeywordTable keywordTable = buildKeywordTable();
+    static_assert(keywordTable.perfect, "Keyword hash has collisions; re-search KeywordHashSeed");
+
+    // Keyword kind for a word, or TokenKind::None for ordinary identifiers.
+    // One hash, one table load and at most one short compare; no allocation.
+    constexpr TokenKind lookupKeyword(std::string_view word) {
+        if (word.size() < MinKeywordLength || word.size() > MaxKeywordLength) {
+            return TokenKind::None;
+        }
+        TokenKind kind = keywordTable.slots[keywordHash(word)];
+        return (kind != TokenKind::None && keywordText(kind) == word) ? kind : TokenKind::None;
+    }
+
+    constexpr bool keywordLookupRoundTrips() {
+        for (size_t i = 0; i < KeywordCount; ++i) {
+            if (lookupKeyword(keywordSpellings[i]) != static_cast<TokenKind>(static_cast<size_t>(FirstKeyword) + i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(keywordLookupRoundTrips(), "Every keyword must map to its own kind");
+    static_assert(lookupKeyword("iff") == TokenKind::None && lookupKeyword("Number") == TokenKind::None,
+        "Non-keywords must not be classified as keywords");
+
+} // namespace Lexer
\ No newline at end of file
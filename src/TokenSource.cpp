@@ -0,0 +1,118 @@
+// TokenSource.cpp
+#include "TokenSource.h"
+#include "StreamLexer.h"
+#include <limits>
+#include <stdexcept>
+
+namespace Lexer {
+
+    const Token& TokenSource::endToken() {
+        static const Token end(TokenType::Unknown, "");
+        return end;
+    }
+
+    // === VectorTokenSource ===
+
+    const Token& VectorTokenSource::peek(size_t ahead) {
+        if (current + ahead >= count) {
+            return endToken();
+        }
+        return tokens[current + ahead];
+    }
+
+    const Token& VectorTokenSource::previous() const {
+        if (current == 0) {
+            return endToken();
+        }
+        return tokens[current - 1];
+    }
+
+    // === LookaheadTokenSource ===
+
+    // Make sure 'count' tokens are buffered from the cursor on, if available
+    bool LookaheadTokenSource::fill(size_t count) {
+        while (buffered < count && !exhausted) {
+            Token& slot = ring[(head + buffered) % ring.size()];
+            if (!fetchToken(slot)) {
+                exhausted = true;
+                break;
+            }
+            buffered++;
+        }
+        return buffered >= count;
+    }
+
+    bool LookaheadTokenSource::fetchToken(Token& token) {
+        while (fetch(token)) {
+            if (token.type != TokenType::Comment) {
+                fetched++;
+                return true;
+            }
+            if (trivia) {
+                trivia->push_back({ fetched, token.offset, token.text().size() });
+            }
+        }
+        return false;
+    }
+
+    bool LookaheadTokenSource::isAtEnd() {
+        return !fill(1);
+    }
+
+    const Token& LookaheadTokenSource::peek(size_t ahead) {
+        if (ahead > MaxLookahead) {
+            throw std::logic_error("Token lookahead exceeds the supported window");
+        }
+        if (!fill(ahead + 1)) {
+            return endToken();
+        }
+        return ring[(head + ahead) % ring.size()];
+    }
+
+    const Token& LookaheadTokenSource::previous() const {
+        if (!hasPrevious) {
+            return endToken();
+        }
+        return ring[(head + ring.size() - 1) % ring.size()];
+    }
+
+    void LookaheadTokenSource::advance() {
+        if (!fill(1)) {
+            return;
+        }
+        // The current slot becomes the previous token in place
+        head = (head + 1) % ring.size();
+        buffered--;
+        hasPrevious = true;
+    }
+
+    // === StringTokenSource ===
+
+    StringTokenSource::StringTokenSource(std::string_view input, std::vector<Trivia>* trivia)
+        : LookaheadTokenSource(trivia), input(input) {
+        if (input.length() > std::numeric_limits<std::uint32_t>::max()) {
+            lexError.code = ErrorCode::InputTooLarge;
+        }
+    }
+
+    bool StringTokenSource::fetch(Token& token) {
+        PackedToken packed{};
+        if (lexError || !nextToken(input, pos, packed, lexError)) {
+            return false;
+        }
+        token.assign(packed.type, packed.text(input), packed.kind, packed.offset);
+        return true;
+    }
+
+    // === StreamTokenSource ===
+
+    bool StreamTokenSource::fetch(Token& token) {
+        if (!lexer.tryNext()) {
+            lexError = lexer.error();
+            return false;
+        }
+        token.assign(lexer.type(), lexer.text(), lexer.kind(), lexer.offset());
+        return true;
+    }
+
+} // namespace Lexer
\ No newline at end of file
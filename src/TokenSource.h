@@ -0,0 +1,125 @@
+#pragma once
+#include "Tokenizer.h"
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Lexer {
+
+    class StreamLexer;
+
+    // Cursor over a sequence of tokens with a small lookahead window.
+    // Parsers read tokens through this instead of owning a token vector.
+    class TokenSource {
+    public:
+        virtual ~TokenSource() = default;
+
+        // Check if we've consumed all tokens
+        virtual bool isAtEnd() = 0;
+
+        // Token 'ahead' positions past the cursor; an empty Unknown token past the end
+        virtual const Token& peek(size_t ahead = 0) = 0;
+
+        // Last consumed token; an empty Unknown token before the first advance()
+        virtual const Token& previous() const = 0;
+
+        // Move the cursor forward by one token
+        virtual void advance() = 0;
+
+        // The token at the cursor, when every token sits in one array that
+        // outlives the source; nullptr for sources that lex on demand
+        virtual const Token* position() const { return nullptr; }
+
+        // Lexical error that ended the token stream early, if any. Sources
+        // that lex on demand stop at malformed input instead of throwing.
+        const Error& error() const { return lexError; }
+
+    protected:
+        static const Token& endToken();
+
+        Error lexError;
+    }; // class TokenSource
+
+    // Walks an existing token vector (or a range of one) without copying it.
+    // The tokens must outlive the source.
+    class VectorTokenSource : public TokenSource {
+    public:
+        explicit VectorTokenSource(const std::vector<Token>& tokens) : tokens(tokens.data()), count(tokens.size()) {}
+        VectorTokenSource(const Token* tokens, size_t count) : tokens(tokens), count(count) {}
+
+        bool isAtEnd() override { return current >= count; }
+        const Token& peek(size_t ahead = 0) override;
+        const Token& previous() const override;
+        void advance() override { if (current < count) current++; }
+        const Token* position() const override { return tokens + current; }
+
+    private:
+        const Token* tokens;
+        size_t count;
+        size_t current = 0;
+    }; // class VectorTokenSource
+
+    // Base for sources that produce tokens on demand. Keeps only the previous
+    // token and up to MaxLookahead upcoming ones, reusing their storage.
+    // Comments are skipped, and recorded in 'trivia' when one is given.
+    class LookaheadTokenSource : public TokenSource {
+    public:
+        static constexpr size_t MaxLookahead = 2;
+
+        explicit LookaheadTokenSource(std::vector<Trivia>* trivia = nullptr) : trivia(trivia) {}
+
+        bool isAtEnd() override;
+        const Token& peek(size_t ahead = 0) override;
+        const Token& previous() const override;
+        void advance() override;
+
+    protected:
+        // Produce the next token into 'token'; return false at end of input
+        virtual bool fetch(Token& token) = 0;
+
+    private:
+        bool fill(size_t count);
+        bool fetchToken(Token& token); // fetch() past any comments
+
+        std::array<Token, MaxLookahead + 2> ring{ {
+            Token(TokenType::Unknown, ""), Token(TokenType::Unknown, ""),
+            Token(TokenType::Unknown, ""), Token(TokenType::Unknown, "") } };
+        size_t head = 0;         // ring index of the current token
+        size_t buffered = 0;     // tokens available from head onwards
+        bool hasPrevious = false;
+        bool exhausted = false;
+        std::vector<Trivia>* trivia;
+        size_t fetched = 0;      // tokens produced so far, the index of the next one
+    }; // class LookaheadTokenSource
+
+    // Lexes a string lazily, one token at a time.
+    // The string must outlive the source.
+    class StringTokenSource : public LookaheadTokenSource {
+    public:
+        explicit StringTokenSource(std::string_view input, std::vector<Trivia>* trivia = nullptr);
+
+    protected:
+        bool fetch(Token& token) override;
+
+    private:
+        std::string_view input;
+        size_t pos = 0;
+    }; // class StringTokenSource
+
+    // Pulls tokens from a chunked StreamLexer
+    class StreamTokenSource : public LookaheadTokenSource {
+    public:
+        explicit StreamTokenSource(StreamLexer& lexer, std::vector<Trivia>* trivia = nullptr)
+            : LookaheadTokenSource(trivia), lexer(lexer) {
+        }
+
+    protected:
+        bool fetch(Token& token) override;
+
+    private:
+        StreamLexer& lexer;
+    }; // class StreamTokenSource
+
+} // namespace Lexer
\ No newline at end of file
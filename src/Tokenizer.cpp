@@ -1,174 +1,225 @@
 // Tokenizer.cpp
 #include "Tokenizer.h"
+#include "Scanner.h"
+#include "OperatorDfa.h"
 #include <stdexcept>
-#include <cctype>
 #include <algorithm>
-#include <unordered_set>
+#include <limits>
 
 namespace Lexer {
 
-    std::vector<Token> tokenize(const std::string& input) {
-        std::vector<Token> tokens;
-        size_t pos = 0;
+    bool nextToken(std::string_view input, size_t& pos, PackedToken& token, Error& error) {
+        // Skip whitespace
+        pos = skipWhitespace(input, pos);
+
+        if (pos >= input.length()) {
+            return false;
+        }
 
-        // Keywords set for O(1) lookup
-        static const std::unordered_set<std::string> keywords = {
-            "if", "else", "while", "return", "for", "function", "number", "word",
-            "boolean", "true", "false", "null", "const", "break", "continue",
-            "main", "print", "input", "or", "and", "not", "do", "switch",
-            "case", "default", "struct", "class", "public", "private", "protected"
+        size_t start = pos;
+        auto emit = [&](TokenType type, TokenKind kind = TokenKind::None) {
+            token.type = type;
+            token.kind = kind;
+            token.offset = static_cast<std::uint32_t>(start);
+            token.length = static_cast<std::uint32_t>(pos - start);
+            return true;
+        };
+        auto fail = [&](ErrorCode code) {
+            error.code = code;
+            error.offset = start;
+            pos = start;
+            return false;
         };
 
-        while (pos < input.length()) {
-            // Skip whitespace
-            if (std::isspace(input[pos])) {
-                pos++;
-                continue;
-            }
+        // Handle identifiers and keywords
+        if (isIdentifierStart(input[pos])) {
+            pos = skipIdentifier(input, pos);
 
-            // Handle identifiers and keywords
-            if (std::isalpha(input[pos]) || input[pos] == '_') {
-                size_t start = pos;
-                while (pos < input.length() && (std::isalnum(input[pos]) || input[pos] == '_')) {
-                    pos++;
-                }
+            // Keywords via the compile-time perfect hash (see TokenKind.h)
+            TokenKind keyword = lookupKeyword(input.substr(start, pos - start));
+            return emit(keyword != TokenKind::None ? TokenType::Keyword : TokenType::Identifier, keyword);
+        }
 
-                std::string word = input.substr(start, pos - start);
+        // Handle numbers (integers and floats)
+        if (isDigitByte(input[pos])) {
+            // Read integer part
+            pos = skipDigits(input, pos);
 
-                if (keywords.count(word) > 0) {
-                    tokens.emplace_back(TokenType::Keyword, word);
-                }
-                else {
-                    tokens.emplace_back(TokenType::Identifier, word);
+            // Check for decimal point
+            if (pos < input.length() && input[pos] == '.') {
+                pos++; // consume '.'
+
+                // Must have at least one digit after decimal point
+                if (pos >= input.length() || !isDigitByte(input[pos])) {
+                    return fail(ErrorCode::InvalidFloat);
                 }
-                continue;
-            }
 
-            // Handle numbers (integers and floats)
-            if (std::isdigit(input[pos])) {
-                size_t start = pos;
+                // Read fractional part
+                pos = skipDigits(input, pos);
+            }
 
-                // Read integer part
-                while (pos < input.length() && std::isdigit(input[pos])) {
-                    pos++;
+            // Shorter literals always fit; only long ones need the range check
+            if (pos - start >= 19) {
+                NumberValue value;
+                if (!decodeNumber(input.substr(start, pos - start), value)) {
+                    error.token.assign(input.substr(start, pos - start));
+                    return fail(ErrorCode::NumberOutOfRange);
                 }
+            }
 
-                // Check for decimal point
-                if (pos < input.length() && input[pos] == '.') {
-                    pos++; // consume '.'
+            return emit(TokenType::Number);
+        }
 
-                    // Must have at least one digit after decimal point
-                    if (pos >= input.length() || !std::isdigit(input[pos])) {
-                        throw std::runtime_error("Invalid float: missing digits after decimal point");
-                    }
+        // Handle strings
+        if (input[pos] == '"') {
+            pos++; // skip opening quote
 
-                    // Read fractional part
-                    while (pos < input.length() && std::isdigit(input[pos])) {
-                        pos++;
-                    }
+            while (true) {
+                pos = findStringDelimiter(input, pos);
+                if (pos >= input.length() || input[pos] == '"') {
+                    break;
                 }
+                // Backslash: skip the escape sequence
+                pos += (pos + 1 < input.length()) ? 2 : 1;
+            }
 
-                tokens.emplace_back(TokenType::Number, input.substr(start, pos - start));
-                continue;
+            if (pos >= input.length()) {
+                return fail(ErrorCode::UnterminatedString);
             }
 
-            // Handle strings
-            if (input[pos] == '"') {
-                size_t start = pos;
-                pos++; // skip opening quote
+            pos++; // skip closing quote
+            return emit(TokenType::String);
+        }
 
-                while (pos < input.length() && input[pos] != '"') {
-                    if (input[pos] == '\\' && pos + 1 < input.length()) {
-                        pos += 2; // skip escape sequence
-                    }
-                    else {
-                        pos++;
-                    }
-                }
+        // Handle single-line comments
+        if (pos + 1 < input.length() && input[pos] == '/' && input[pos + 1] == '/') {
+            pos = findLineEnd(input, pos + 2);
+            return emit(TokenType::Comment);
+        }
 
-                if (pos >= input.length()) {
-                    throw std::runtime_error("Unterminated string literal");
-                }
+        // Handle block comments
+        if (pos + 1 < input.length() && input[pos] == '/' && input[pos + 1] == '*') {
+            // Look for closing */
+            pos = findBlockCommentEnd(input, pos + 2);
 
-                pos++; // skip closing quote
-                tokens.emplace_back(TokenType::String, input.substr(start, pos - start));
-                continue;
+            if (pos >= input.length()) {
+                // Reached end without finding closing */
+                return fail(ErrorCode::UnterminatedComment);
             }
 
-            // Handle single-line comments
-            if (pos + 1 < input.length() && input[pos] == '/' && input[pos + 1] == '/') {
-                size_t start = pos;
-                pos += 2;
-                while (pos < input.length() && input[pos] != '\n') {
-                    pos++;
-                }
-                tokens.emplace_back(TokenType::Comment, input.substr(start, pos - start));
-                continue;
-            }
+            // Found closing */, consume it
+            pos += 2;
+            return emit(TokenType::Comment);
+        }
 
-            // Handle block comments
-            if (pos + 1 < input.length() && input[pos] == '/' && input[pos + 1] == '*') {
-                size_t start = pos;
-                pos += 2;
+        // Handle operators and punctuation (longest match wins)
+        size_t length = 0;
+        TokenKind kind = operatorDfa.match(input, pos, length);
+        if (kind == TokenKind::None) {
+            error.token.assign(1, input[pos]);
+            return fail(ErrorCode::UnrecognizedCharacter);
+        }
 
-                // Look for closing */
-                while (pos < input.length() &&
-                    !(input[pos] == '*' && pos + 1 < input.length() && input[pos + 1] == '/')) {
-                    pos++;
-                }
+        pos += length;
+        return emit(isPunctuation(kind) ? TokenType::Punctuation : TokenType::Operator, kind);
+    }
 
-                if (pos < input.length()) {
-                    // Found closing */, consume it
-                    pos += 2;
-                    tokens.emplace_back(TokenType::Comment, input.substr(start, pos - start));
-                }
-                else {
-                    // Reached end without finding closing */
-                    throw std::runtime_error("Unterminated block comment");
-                }
-                continue;
+    bool nextToken(std::string_view input, size_t& pos, PackedToken& token) {
+        Error error;
+        if (nextToken(input, pos, token, error)) {
+            return true;
+        }
+        if (error) {
+            throw SyntaxError(std::move(error));
+        }
+        return false;
+    }
+
+    bool tokenizeInto(std::string_view input, std::vector<PackedToken>& out, Error& error) {
+        // Offsets are 32-bit to keep the record small
+        if (input.length() > std::numeric_limits<std::uint32_t>::max()) {
+            error.code = ErrorCode::InputTooLarge;
+            return false;
+        }
+
+        size_t pos = 0;
+        PackedToken token{};
+        while (nextToken(input, pos, token, error)) {
+            out.push_back(token);
+        }
+        return !error;
+    }
+
+    void tokenizeInto(std::string_view input, std::vector<PackedToken>& out) {
+        Error error;
+        if (!tokenizeInto(input, out, error)) {
+            throw SyntaxError(std::move(error));
+        }
+    }
+
+    TokenBuffer::TokenBuffer(std::string source) : source_(std::move(source)) {
+        tokenizeInto(source_, tokens_);
+        tokens_.shrink_to_fit();
+    }
+
+    TokenBuffer tokenizePacked(std::string input) {
+        return TokenBuffer(std::move(input));
+    }
+
+    std::pair<const Trivia*, const Trivia*> triviaBefore(const std::vector<Trivia>& trivia, size_t token) {
+        auto first = std::lower_bound(trivia.begin(), trivia.end(), token,
+            [](const Trivia& entry, size_t index) { return entry.token < index; });
+        auto last = std::find_if(first, trivia.end(), [&](const Trivia& entry) { return entry.token != token; });
+        return { trivia.data() + (first - trivia.begin()), trivia.data() + (last - trivia.begin()) };
+    }
+
+    namespace {
+
+        Result<std::vector<Token>> tokenizeTokens(const std::string& input, std::vector<Trivia>* trivia) {
+            Result<std::vector<Token>> result;
+            std::vector<PackedToken> packed;
+            if (!tokenizeInto(input, packed, result.error)) {
+                return result;
             }
 
-            // Handle multi-character operators
-            if (pos + 1 < input.length()) {
-                std::string twoChar = input.substr(pos, 2);
-
-                // Comparison and logical operators
-                if (twoChar == "==" || twoChar == "!=" || twoChar == "<=" ||
-                    twoChar == ">=" || twoChar == "&&" || twoChar == "||" ||
-                    twoChar == "++" || twoChar == "--" || twoChar == "+=" ||
-                    twoChar == "-=" || twoChar == "*=" || twoChar == "/=" ||
-                    twoChar == "%=" || twoChar == "<<" || twoChar == ">>") {
-                    tokens.emplace_back(TokenType::Operator, twoChar);
-                    pos += 2;
+            result.value.reserve(packed.size());
+            for (const auto& token : packed) {
+                if (token.type == TokenType::Comment) {
+                    if (trivia) {
+                        trivia->push_back({ result.value.size(), token.offset, token.length });
+                    }
                     continue;
                 }
+                result.value.emplace_back(token.type, token.text(input), token.kind, token.offset);
             }
 
-            // Handle single-character tokens
-            char ch = input[pos];
-            switch (ch) {
-                // Arithmetic operators
-            case '+': case '-': case '*': case '/': case '%':
-            case '^': case '=': case '!': case '<': case '>':
-            case '&': case '|': case '~':
-                tokens.emplace_back(TokenType::Operator, std::string(1, ch));
-                break;
-
-                // Punctuation and delimiters
-            case ';': case ',': case '.': case ':':
-            case '(': case ')': case '{': case '}': case '[': case ']':
-                tokens.emplace_back(TokenType::Punctuation, std::string(1, ch));
-                break;
-
-            default:
-                throw std::runtime_error("Unrecognized character: '" + std::string(1, ch) + "'");
-            }
+            return result;
+        }
+
+    } // namespace
 
-            pos++;
+    Result<std::vector<Token>> tryTokenize(const std::string& input) {
+        return tokenizeTokens(input, nullptr);
+    }
+
+    Result<std::vector<Token>> tryTokenize(const std::string& input, std::vector<Trivia>& trivia) {
+        return tokenizeTokens(input, &trivia);
+    }
+
+    std::vector<Token> tokenize(const std::string& input) {
+        auto result = tryTokenize(input);
+        if (!result) {
+            throw SyntaxError(std::move(result.error));
         }
+        return std::move(result.value);
+    }
 
-        return tokens;
+    std::vector<Token> tokenize(const std::string& input, std::vector<Trivia>& trivia) {
+        auto result = tryTokenize(input, trivia);
+        if (!result) {
+            throw SyntaxError(std::move(result.error));
+        }
+        return std::move(result.value);
     }
 
     std::string tokenTypeToString(TokenType type) {
@@ -1,14 +1,22 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
+#include <utility>
+#include <cstdint>
 #include <stdexcept>
 #include <cctype>
 #include <iostream>
+#include "TokenKind.h"
+#include "Error.h"
+#include "Literal.h"
+#include "Number.h"
+#include "Symbol.h"
 
 namespace Lexer {
 
     // Enum for token types
-    enum class TokenType {
+    enum class TokenType : std::uint8_t {
         Identifier,
         Keyword,
         Number, 
@@ -20,17 +28,147 @@ namespace Lexer {
         Unknown
     }; // enum TokenType
 
-    // Struct to represent a token
+    // Struct to represent a token. Only tokens without a symbol or a fixed
+    // spelling (numbers, strings, comments, unknown text) keep a copy of
+    // their lexeme; text() spells the others from their symbol or kind.
+    // A string with escapes keeps its decoded contents in the same buffer,
+    // after the lexeme.
     struct Token {
         TokenType type;
-        std::string value;
+        TokenKind kind = TokenKind::None; // specific keyword/operator/punctuation, if any
+        Symbol symbol;                    // interned name of an identifier (empty otherwise)
+        std::uint64_t offset = 0;         // byte offset into the source
+        size_t decodedAt = 0;             // where decoded contents start in literal (0 if not decoded)
+        NumberValue number;               // decoded value of a number (zero otherwise)
+        std::string literal;              // lexeme of a token without symbol or kind, then any decoded contents
 
         // Constructor for easier token creation
-        Token(TokenType t, const std::string& v) : type(t), value(v) {}
+        Token(TokenType t, std::string_view v, TokenKind k = TokenKind::None, std::uint64_t o = 0) {
+            assign(t, v, k, o);
+        }
+
+        // Set every field from the lexeme: identifiers are interned and
+        // numbers decoded here, once, so the parser never re-reads the text
+        void assign(TokenType t, std::string_view v, TokenKind k, std::uint64_t o) {
+            type = t;
+            kind = k;
+            offset = o;
+            symbol = t == TokenType::Identifier ? Symbol::intern(v) : Symbol();
+            if (t == TokenType::Identifier || k != TokenKind::None) {
+                literal.clear();
+            }
+            else {
+                literal.assign(v);
+            }
+            decodedAt = 0;
+            if (t == TokenType::String && hasEscapes(v)) {
+                decodedAt = literal.size();
+                decodeString(v, literal);
+            }
+            number = NumberValue();
+            if (t == TokenType::Number) {
+                decodeNumber(v, number);
+            }
+        }
+
+        // The lexeme as written in the source
+        std::string_view text() const {
+            if (type == TokenType::Identifier) {
+                return symbol.text();
+            }
+            if (kind != TokenKind::None) {
+                return tokenKindText(kind);
+            }
+            return std::string_view(literal.data(), decodedAt != 0 ? decodedAt : literal.size());
+        }
+
+        // Contents of a string with escapes decoded: a slice of the lexeme
+        // unless it has escapes (empty for other tokens). Valid while the token is.
+        std::string_view decoded() const {
+            if (type != TokenType::String) {
+                return std::string_view();
+            }
+            return decodedAt != 0 ? std::string_view(literal).substr(decodedAt) : stringSlice(literal);
+        }
     }; // struct Token
 
-    // Function to tokenize a string input
+    // A comment, kept beside the token stream instead of in it. Trivia is
+    // recorded in source order, so it is sorted by token index.
+    struct Trivia {
+        size_t token;         // index of the token the comment precedes (the token count for trailing comments)
+        std::uint64_t offset; // byte offset into the source
+        size_t length;        // byte length of the comment
+
+        std::string_view text(std::string_view source) const {
+            return source.substr(offset, length);
+        }
+    }; // struct Trivia
+
+    // Comments directly before token index 'token', as [first, second)
+    std::pair<const Trivia*, const Trivia*> triviaBefore(const std::vector<Trivia>& trivia, size_t token);
+
+    // Compact token: a span into the source it was lexed from.
+    // Trivially copyable, so a token stream is a single flat allocation.
+    struct PackedToken {
+        TokenType type;
+        TokenKind kind;       // specific keyword/operator/punctuation, if any
+        std::uint32_t offset; // byte offset into the source
+        std::uint32_t length; // byte length of the lexeme
+
+        std::string_view text(std::string_view source) const {
+            return source.substr(offset, length);
+        }
+    }; // struct PackedToken
+
+    // Owns a copy of the source and the packed tokens that point into it
+    class TokenBuffer {
+    public:
+        TokenBuffer() = default;
+        explicit TokenBuffer(std::string source);
+
+        const std::string& source() const { return source_; }
+        const std::vector<PackedToken>& tokens() const { return tokens_; }
+
+        size_t size() const { return tokens_.size(); }
+        bool empty() const { return tokens_.empty(); }
+        const PackedToken& operator[](size_t index) const { return tokens_[index]; }
+        std::vector<PackedToken>::const_iterator begin() const { return tokens_.begin(); }
+        std::vector<PackedToken>::const_iterator end() const { return tokens_.end(); }
+
+        // Text of a token as a view into the owned source
+        std::string_view text(const PackedToken& token) const { return token.text(source_); }
+        std::string_view text(size_t index) const { return tokens_[index].text(source_); }
+
+    private:
+        std::string source_;
+        std::vector<PackedToken> tokens_;
+    }; // class TokenBuffer
+
+    // Function to tokenize a string input (throws SyntaxError). The result is
+    // what the parsers read: comments are left out, or moved to 'trivia'.
     std::vector<Token> tokenize(const std::string& input);
+    std::vector<Token> tokenize(const std::string& input, std::vector<Trivia>& trivia);
     std::string tokenTypeToString(TokenType type);
 
+    // tokenize() without exceptions: a lexical error is returned in the result
+    Result<std::vector<Token>> tryTokenize(const std::string& input);
+    Result<std::vector<Token>> tryTokenize(const std::string& input, std::vector<Trivia>& trivia);
+
+    // Scan a single token starting at pos, skipping leading whitespace.
+    // Returns false once the end of input is reached, or on a lexical error,
+    // which is stored in error (pos is then left at the offending token).
+    bool nextToken(std::string_view input, size_t& pos, PackedToken& token, Error& error);
+
+    // As above, throwing SyntaxError on a lexical error
+    bool nextToken(std::string_view input, size_t& pos, PackedToken& token);
+
+    // Append the packed tokens of input to out without any per-token allocation.
+    // Every lexeme is kept, comments included.
+    // Returns false on a lexical error, with the tokens before it appended.
+    bool tokenizeInto(std::string_view input, std::vector<PackedToken>& out, Error& error);
+    void tokenizeInto(std::string_view input, std::vector<PackedToken>& out); // throws SyntaxError
+
+    // Tokenize into a self-contained buffer that owns its source
+    TokenBuffer tokenizePacked(std::string input);
+
 } // namespace Lexer
\ No newline at end of file
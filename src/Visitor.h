@@ -0,0 +1,129 @@
+#pragma once
+#include "AST.h"
+
+namespace AST {
+
+    // Static (CRTP) visitor over the class tree.
+    // Derived implements visitNumber, visitBinary, ... for the node types it
+    // cares about; the others fall back to visitDefault, which returns Result()
+    // unless Derived overrides it. Dispatch is one switch on the node's kind
+    // tag: no RTTI and no virtual calls.
+    //
+    //     struct CountIdentifiers : Visitor<CountIdentifiers> {
+    //         int count = 0;
+    //         void visitIdentifier(const Identifier&) { ++count; }
+    //         void visitDefault(const ASTNode& node) { visitChildren(node); }
+    //     };
+    template <class Derived, class Result = void>
+    class Visitor {
+    public:
+        Result visit(const ASTNode& node) {
+            switch (node.kind) {
+            case NodeKind::Number:
+                return self().visitNumber(static_cast<const NumberLiteral&>(node));
+            case NodeKind::Identifier:
+                return self().visitIdentifier(static_cast<const Identifier&>(node));
+            case NodeKind::Boolean:
+                return self().visitBoolean(static_cast<const BooleanLiteral&>(node));
+            case NodeKind::String:
+                return self().visitString(static_cast<const StringLiteral&>(node));
+            case NodeKind::Binary:
+                return self().visitBinary(static_cast<const BinaryOperation&>(node));
+            case NodeKind::Unary:
+                return self().visitUnary(static_cast<const UnaryOperation&>(node));
+            case NodeKind::PreIncrement:
+                return self().visitPreIncrement(static_cast<const PreIncrement&>(node));
+            case NodeKind::PostIncrement:
+                return self().visitPostIncrement(static_cast<const PostIncrement&>(node));
+            case NodeKind::PostIncrementOperation:
+                return self().visitPostIncrementOperation(static_cast<const PostIncrementOperation&>(node));
+            case NodeKind::VariableDeclaration:
+                return self().visitVariableDeclaration(static_cast<const VariableDeclaration&>(node));
+            case NodeKind::Assignment:
+                return self().visitAssignment(static_cast<const AssignmentStatement&>(node));
+            case NodeKind::ExpressionStatement:
+                return self().visitExpressionStatement(static_cast<const ExpressionStatement&>(node));
+            case NodeKind::Block:
+                return self().visitBlock(static_cast<const Block&>(node));
+            case NodeKind::If:
+                return self().visitIf(static_cast<const IfStatement&>(node));
+            case NodeKind::LazyBlock:
+                return self().visitLazyBlock(static_cast<const LazyBlock&>(node));
+            }
+            return self().visitDefault(node);
+        }
+
+        // Per-kind hooks (hidden by Derived)
+        Result visitNumber(const NumberLiteral& node) { return self().visitDefault(node); }
+        Result visitIdentifier(const Identifier& node) { return self().visitDefault(node); }
+        Result visitBoolean(const BooleanLiteral& node) { return self().visitDefault(node); }
+        Result visitString(const StringLiteral& node) { return self().visitDefault(node); }
+        Result visitBinary(const BinaryOperation& node) { return self().visitDefault(node); }
+        Result visitUnary(const UnaryOperation& node) { return self().visitDefault(node); }
+        Result visitPreIncrement(const PreIncrement& node) { return self().visitDefault(node); }
+        Result visitPostIncrement(const PostIncrement& node) { return self().visitDefault(node); }
+        Result visitPostIncrementOperation(const PostIncrementOperation& node) { return self().visitDefault(node); }
+        Result visitVariableDeclaration(const VariableDeclaration& node) { return self().visitDefault(node); }
+        Result visitAssignment(const AssignmentStatement& node) { return self().visitDefault(node); }
+        Result visitExpressionStatement(const ExpressionStatement& node) { return self().visitDefault(node); }
+        Result visitBlock(const Block& node) { return self().visitDefault(node); }
+        Result visitIf(const IfStatement& node) { return self().visitDefault(node); }
+
+        // A lazy block is visited as its body, which parses it
+        // (throws Lexer::SyntaxError if the body does not parse)
+        Result visitLazyBlock(const LazyBlock& node) { return self().visit(node.body()); }
+
+        Result visitDefault(const ASTNode&) { return Result(); }
+
+        // Visit the direct children of a node in source order (results are discarded)
+        void visitChildren(const ASTNode& node) {
+            switch (node.kind) {
+            case NodeKind::Binary: {
+                auto& binary = static_cast<const BinaryOperation&>(node);
+                self().visit(*binary.left);
+                self().visit(*binary.right);
+                break;
+            }
+            case NodeKind::Unary:
+                self().visit(*static_cast<const UnaryOperation&>(node).operand);
+                break;
+            case NodeKind::VariableDeclaration: {
+                auto& declaration = static_cast<const VariableDeclaration&>(node);
+                if (declaration.initializer) {
+                    self().visit(*declaration.initializer);
+                }
+                break;
+            }
+            case NodeKind::Assignment:
+                self().visit(*static_cast<const AssignmentStatement&>(node).value);
+                break;
+            case NodeKind::ExpressionStatement:
+                self().visit(*static_cast<const ExpressionStatement&>(node).expression);
+                break;
+            case NodeKind::Block:
+                for (const auto& stmt : static_cast<const Block&>(node).statements) {
+                    self().visit(*stmt);
+                }
+                break;
+            case NodeKind::If: {
+                auto& ifStatement = static_cast<const IfStatement&>(node);
+                self().visit(*ifStatement.condition);
+                self().visit(*ifStatement.thenStatement);
+                if (ifStatement.elseStatement) {
+                    self().visit(*ifStatement.elseStatement);
+                }
+                break;
+            }
+            case NodeKind::LazyBlock:
+                visitChildren(static_cast<const LazyBlock&>(node).body());
+                break;
+            default:
+                break; // leaves
+            }
+        }
+
+    protected:
+        Derived& self() { return static_cast<Derived&>(*this); }
+    }; // class Visitor
+
+} // namespace AST
\ No newline at end of file
@@ -2,7 +2,9 @@
 #include "CppUnitTest.h"
 #include "../src/Tokenizer.h"
 #include "../src/ExpressionParser.h"
+#include "../src/Visitor.h"
 #include "../src/ExpressionParser.cpp"
+#include "../src/TokenSource.cpp"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Lexer;
@@ -11,10 +13,32 @@ using namespace AST;
 
 namespace ExpressionParserTests
 {
+    // Evaluates integer expressions over + - * and unary minus
+    struct Evaluator : Visitor<Evaluator, long long> {
+        long long visitNumber(const NumberLiteral& node) { return node.number.integer; }
+
+        long long visitUnary(const UnaryOperation& node) {
+            return node.operator_ == TokenKind::Minus ? -visit(*node.operand) : visit(*node.operand);
+        }
+
+        long long visitBinary(const BinaryOperation& node) {
+            long long left = visit(*node.left);
+            long long right = visit(*node.right);
+            switch (node.operator_) {
+            case TokenKind::Plus: return left + right;
+            case TokenKind::Minus: return left - right;
+            case TokenKind::Star: return left * right;
+            default: throw std::runtime_error("Unsupported operator");
+            }
+        }
+
+        long long visitDefault(const ASTNode&) { throw std::runtime_error("Not a constant"); }
+    };
+
     TEST_CLASS(ExpressionParserTests)
     {
     private:
-        std::unique_ptr<Expression> parseExpression(const std::string& input) {
+        ExpressionPtr parseExpression(const std::string& input) {
             auto tokens = tokenize(input);
             ExpressionParser parser(tokens);
             return parser.parse();
@@ -302,5 +326,328 @@ namespace ExpressionParserTests
                 parseExpression("++");  // Incomplete increment
                 });
         }
+
+        // Lazy token source
+        TEST_METHOD(ParseFromLazyTokenSource)
+        {
+            std::string input = "not a + b * c > d and e or f";
+            StringTokenSource source(input);
+            ExpressionParser parser(source);
+
+            auto ast = parser.parse();
+            Assert::IsNotNull(ast.get());
+            Assert::AreEqual(parseExpression(input)->toString(), ast->toString());
+        }
+
+        TEST_METHOD(ParseErrorStopsLazyLexing)
+        {
+            // The parser fails at ')' before the lexer ever reaches '@'
+            std::string input = "2 + ) @";
+            StringTokenSource source(input);
+            ExpressionParser parser(source);
+
+            Assert::ExpectException<std::runtime_error>([&parser]() {
+                parser.parse();
+                });
+            Assert::AreEqual(std::string(")"), std::string(source.peek().text()));
+        }
+
+        TEST_METHOD(BinaryLevelsByTokenKind)
+        {
+            Assert::IsTrue(binaryLevel(TokenKind::KwOr) == BinaryLevel::LogicalOr);
+            Assert::IsTrue(binaryLevel(TokenKind::AmpAmp) == BinaryLevel::LogicalAnd);
+            Assert::IsTrue(binaryLevel(TokenKind::BangEqual) == BinaryLevel::Equality);
+            Assert::IsTrue(binaryLevel(TokenKind::LessEqual) == BinaryLevel::Comparison);
+            Assert::IsTrue(binaryLevel(TokenKind::Minus) == BinaryLevel::Term);
+            Assert::IsTrue(binaryLevel(TokenKind::Percent) == BinaryLevel::Factor);
+            Assert::IsTrue(binaryLevel(TokenKind::Pipe) == BinaryLevel::BitwiseOr);
+            Assert::IsTrue(binaryLevel(TokenKind::Caret) == BinaryLevel::BitwiseXor);
+            Assert::IsTrue(binaryLevel(TokenKind::Amp) == BinaryLevel::BitwiseAnd);
+            Assert::IsTrue(binaryLevel(TokenKind::ShiftRight) == BinaryLevel::Shift);
+            Assert::IsTrue(binaryLevel(TokenKind::Assign) == BinaryLevel::None);
+            Assert::IsTrue(binaryLevel(TokenKind::None) == BinaryLevel::None);
+        }
+
+
+        // Bitwise operators
+        TEST_METHOD(ParseBitwisePrecedence)
+        {
+            // | binds looser than ^, which binds looser than &
+            auto ast = parseExpression("a | b ^ c & d");
+            Assert::AreEqual(std::string("(a | (b ^ (c & d)))"), ast->toString());
+
+            // & binds looser than equality, shifts bind looser than + and tighter than <
+            ast = parseExpression("a & b == c");
+            Assert::AreEqual(std::string("(a & (b == c))"), ast->toString());
+
+            ast = parseExpression("a << b + c < d");
+            Assert::AreEqual(std::string("((a << (b + c)) < d)"), ast->toString());
+
+            // Logical operators bind looser than every bitwise operator
+            ast = parseExpression("a | b && c");
+            Assert::AreEqual(std::string("((a | b) && c)"), ast->toString());
+        }
+
+        TEST_METHOD(ParseBitwiseLeftAssociativity)
+        {
+            auto ast = parseExpression("a >> b >> c");
+            Assert::AreEqual(std::string("((a >> b) >> c)"), ast->toString());
+
+            ast = parseExpression("a & b & c");
+            Assert::AreEqual(std::string("((a & b) & c)"), ast->toString());
+        }
+
+
+        // Arena allocation
+        TEST_METHOD(ParseExpressionIntoArena)
+        {
+            std::string input = "not a + b * c > d and some_rather_long_identifier_name or f++";
+            auto expected = parseExpression(input)->toString();
+            Arena arena;
+
+            ExpressionPtr ast;
+            {
+                ArenaScope scope(arena);
+                ast = parseExpression(input);
+            }
+
+            Assert::IsTrue(ast->inArena());
+            Assert::IsTrue(arena.bytesAllocated() > 0);
+            Assert::AreEqual(expected, ast->toString());
+        }
+
+
+        // Node kinds and visitors
+        TEST_METHOD(NodeKindsAndOperators)
+        {
+            auto ast = parseExpression("a and not b");
+
+            Assert::IsTrue(ast->kind == NodeKind::Binary);
+            auto binary = nodeAs<BinaryOperation>(*ast);
+            Assert::IsNotNull(binary);
+            Assert::IsTrue(binary->operator_ == TokenKind::KwAnd);
+            Assert::IsTrue(binary->left->kind == NodeKind::Identifier);
+            Assert::IsNull(nodeAs<Identifier>(*binary->right));
+            Assert::IsTrue(nodeAs<UnaryOperation>(*binary->right)->operator_ == TokenKind::KwNot);
+
+            // The spelling is kept: && and 'and' print differently
+            Assert::AreEqual(std::string("(a && b)"), parseExpression("a && b")->toString());
+        }
+
+        TEST_METHOD(VisitorEvaluatesExpression)
+        {
+            Evaluator evaluator;
+            Assert::AreEqual(14LL, evaluator.visit(*parseExpression("2 + 3 * 4")));
+            Assert::AreEqual(-20LL, evaluator.visit(*parseExpression("-(2 + 3) * 4")));
+
+            Assert::ExpectException<std::runtime_error>([this, &evaluator]() {
+                evaluator.visit(*parseExpression("2 + x"));
+                });
+        }
+
+
+        TEST_METHOD(ExplicitStackMatchesRecursiveParse)
+        {
+            // Arrange
+            const char* inputs[] = {
+                "1 + 2 * 3 - 4", "-(a + b) * not c", "a or b and c | d ^ e & f == g < h << i + j * k",
+                "((x))", "++i + j--", "\"s\" == true", "not not -x", "a & (b | c)",
+            };
+            ParseOptions options;
+            options.explicitStack = true;
+
+            for (const char* input : inputs) {
+                // Act
+                auto tokens = tokenize(input);
+                ExpressionParser recursive(tokens);
+                ExpressionParser iterative(tokens);
+                iterative.setOptions(options);
+
+                // Assert
+                Assert::AreEqual(recursive.parse()->toString(), iterative.parse()->toString());
+            }
+        }
+
+        TEST_METHOD(ExplicitStackReportsSameErrors)
+        {
+            const char* inputs[] = { "(1 + 2", "1 +", "* 2", "-", "(", "1 2" };
+            ParseOptions options;
+            options.explicitStack = true;
+
+            for (const char* input : inputs) {
+                auto tokens = tokenize(input);
+                std::string recursiveError, iterativeError;
+                try { ExpressionParser(tokens).parse(); } catch (const std::runtime_error& e) { recursiveError = e.what(); }
+
+                ExpressionParser iterative(tokens);
+                iterative.setOptions(options);
+                try { iterative.parse(); } catch (const std::runtime_error& e) { iterativeError = e.what(); }
+
+                Assert::IsFalse(recursiveError.empty());
+                Assert::AreEqual(recursiveError, iterativeError);
+            }
+        }
+
+        TEST_METHOD(ParseDeeplyNestedExpression)
+        {
+            // Arrange: far deeper than the C++ stack allows recursively
+            const size_t depth = 100000;
+            std::string prefix, parens;
+            for (size_t i = 0; i < depth; ++i) {
+                prefix += "not ";
+                parens += "(";
+            }
+            parens += "x" + std::string(depth, ')');
+
+            ParseOptions options;
+            options.explicitStack = true; // with no depth limit by default
+
+            // Act
+            ExpressionParser notParser(tokenize(prefix + "x"));
+            notParser.setOptions(options);
+            auto notChain = notParser.parse();
+
+            ExpressionParser parenParser(tokenize(parens));
+            parenParser.setOptions(options);
+            auto parenChain = parenParser.parse();
+
+            // Assert: printing and destruction are iterative too
+            std::string printed = notChain->toString();
+            Assert::AreEqual(depth * 6 + 1, printed.size()); // "(not " + ")" per level
+            Assert::AreEqual(std::string("x"), parenChain->toString());
+        }
+
+        TEST_METHOD(NestingLimitFailsCleanly)
+        {
+            std::string input(300, '(');
+            input += "1" + std::string(300, ')');
+            auto tokens = tokenize(input);
+
+            // The recursive default, and the same limit set for an explicit stack
+            ParseOptions recursive;
+            ParseOptions explicitLimited;
+            explicitLimited.explicitStack = true;
+            explicitLimited.maxDepth = ParseOptions::DefaultMaxDepth;
+            for (const ParseOptions& options : { recursive, explicitLimited }) {
+                ExpressionParser parser(tokens);
+                parser.setOptions(options);
+
+                try {
+                    parser.parse();
+                    Assert::Fail(L"Expected nesting limit error");
+                }
+                catch (const std::runtime_error& e) {
+                    Assert::AreEqual(std::string("Nesting too deep (limit is 256)"), std::string(e.what()));
+                }
+            }
+
+            // An explicit stack has no limit by default
+            ParseOptions unlimited;
+            unlimited.explicitStack = true;
+            ExpressionParser deep(tokens);
+            deep.setOptions(unlimited);
+            Assert::AreEqual(std::string("1"), deep.parse()->toString());
+
+            // Exactly at the limit is fine
+            std::string atLimit;
+            for (int i = 0; i < 256; ++i) {
+                atLimit += "- ";
+            }
+            ExpressionParser parser(tokenize(atLimit + "1"));
+            Assert::AreEqual(size_t(256 * 4 + 1), parser.parse()->toString().size());
+        }
+
+
+        TEST_METHOD(TryParseReportsErrorWithoutThrowing)
+        {
+            struct Case { const char* input; ErrorCode code; std::uint64_t offset; };
+            const Case cases[] = {
+                { "1 +", ErrorCode::UnexpectedEnd, 3 },
+                { "1 + * 2", ErrorCode::UnexpectedToken, 4 },
+                { "(1 + 2", ErrorCode::Expected, 6 },
+                { "1 2", ErrorCode::TrailingToken, 2 },
+                { "++ 3", ErrorCode::ExpectedIdentifier, 3 },
+                { "(a + b)++", ErrorCode::InvalidIncrementTarget, 7 },
+            };
+
+            for (const auto& c : cases) {
+                // Act
+                auto tokens = tokenize(c.input);
+                auto result = ExpressionParser(tokens).tryParse();
+
+                // Assert: same message as the throwing API
+                Assert::IsFalse(static_cast<bool>(result));
+                Assert::IsTrue(result.error.code == c.code);
+                Assert::AreEqual(c.offset, result.error.offset);
+                try {
+                    ExpressionParser(tokens).parse();
+                    Assert::Fail(L"Expected a syntax error");
+                }
+                catch (const std::runtime_error& e) {
+                    Assert::AreEqual(result.error.message(), std::string(e.what()));
+                }
+            }
+
+            auto ok = ExpressionParser(tokenize("a * (b + 1)")).tryParse();
+            Assert::IsTrue(static_cast<bool>(ok));
+            Assert::AreEqual(std::string("(a * (b + 1))"), ok.value->toString());
+        }
+
+        TEST_METHOD(TryParseReportsLexicalErrorsFromLazySource)
+        {
+            // The lexer stops at '@'; the parser reports that instead of "Unexpected end of input"
+            std::string input = "1 + @";
+            StringTokenSource source(input);
+            auto result = ExpressionParser(source).tryParse();
+
+            Assert::IsTrue(result.error.code == ErrorCode::UnrecognizedCharacter);
+            Assert::AreEqual(std::uint64_t(4), result.error.offset);
+
+            // A complete expression followed by malformed input still fails
+            std::string trailing = "1 + 2 \"open";
+            StringTokenSource trailingSource(trailing);
+            Assert::IsTrue(ExpressionParser(trailingSource).tryParse().error.code == ErrorCode::UnterminatedString);
+        }
+
+        TEST_METHOD(IdentifiersAreInterned)
+        {
+            // Arrange: the same name through a vector source and a lazy string source
+            auto tokens = tokenize("count + count");
+            StringTokenSource lazy("count++");
+
+            // Act
+            auto ast = ExpressionParser(tokens).parse();
+            auto increment = ExpressionParser(lazy).parse();
+
+            // Assert
+            auto binary = nodeAs<BinaryOperation>(*ast);
+            Symbol left = nodeAs<Identifier>(*binary->left)->name;
+            Assert::IsTrue(left == nodeAs<Identifier>(*binary->right)->name);
+            Assert::IsTrue(left == nodeAs<PostIncrement>(*increment)->variable);
+            Assert::IsTrue(left == Symbol::intern("count"));
+            Assert::AreEqual(std::string("(count + count)"), ast->toString());
+        }
+
+        TEST_METHOD(StringLiteralKeepsSpellingAndContents)
+        {
+            auto ast = parseExpression(R"(greeting + "hi\tyou\"")");
+
+            auto literal = nodeAs<StringLiteral>(*nodeAs<BinaryOperation>(*ast)->right);
+            Assert::AreEqual(std::string("hi\tyou\""), std::string(literal->decoded));
+            Assert::AreEqual(std::string(R"((greeting + "hi\tyou\""))"), ast->toString());
+
+            // One allocation holds the spelling, then the decoded contents
+            Assert::IsTrue(literal->decoded.data() == literal->value.data() + literal->value.size());
+        }
+
+        TEST_METHOD(PlainStringLiteralSlicesItsSpelling)
+        {
+            auto ast = parseExpression(R"("plain")");
+
+            auto literal = nodeAs<StringLiteral>(*ast);
+            Assert::AreEqual(std::string(R"("plain")"), std::string(literal->value));
+            Assert::AreEqual(std::string("plain"), std::string(literal->decoded));
+            Assert::IsTrue(literal->decoded.data() == literal->value.data() + 1);
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../src/Tokenizer.h"
+#include "../src/FlatAST.h"
+#include "../src/StatementParser.h"
+#include "../src/FlatAST.cpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lexer;
+using namespace Parser;
+using namespace AST;
+
+namespace FlatASTTests
+{
+    TEST_CLASS(FlatASTTests)
+    {
+    private:
+        const std::string program =
+            "number x = 5; word s = \"hi\"; boolean b = not true;\n"
+            "x = x + 1 * -y;\n"
+            "if (x > 5 and b) { x = 0; ++x; } else x--;\n"
+            "{ }";
+
+        std::vector<std::string> printAll(const std::vector<StatementPtr>& statements) {
+            std::vector<std::string> printed;
+            for (const auto& stmt : statements) {
+                printed.push_back(stmt->toString());
+            }
+            return printed;
+        }
+
+        void assertSamePrinted(const std::vector<std::string>& expected, const std::vector<StatementPtr>& actual) {
+            auto printed = printAll(actual);
+            Assert::AreEqual(expected.size(), printed.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                Assert::AreEqual(expected[i], printed[i]);
+            }
+        }
+
+    public:
+
+        TEST_METHOD(FlatParserMatchesTreeParser)
+        {
+            // Arrange
+            auto tokens = tokenize(program);
+            StatementParser treeParser(tokens);
+            auto expected = printAll(treeParser.parseStatements());
+
+            // Act
+            FlatTree tree;
+            FlatStatementParser flatParser(tokens, FlatBuilder(tree));
+            tree.roots = flatParser.parseStatements();
+
+            // Assert
+            Assert::AreEqual(size_t(6), tree.roots.size());
+            assertSamePrinted(expected, toStatements(tree));
+        }
+
+        TEST_METHOD(FlatExpressionLayout)
+        {
+            // Arrange
+            FlatTree tree;
+            FlatExpressionParser parser(tokenize("a + b * 2"), FlatBuilder(tree));
+
+            // Act
+            NodeId root = parser.parse();
+
+            // Assert: children are emitted before their parent
+            Assert::AreEqual(size_t(5), tree.size());
+            Assert::AreEqual(NodeId(4), root);
+            Assert::IsTrue(tree.kinds[root] == NodeKind::Binary);
+            Assert::IsTrue(tree.ops[root] == TokenKind::Plus);
+
+            NodeId left = tree.first[root];
+            NodeId right = tree.second[root];
+            Assert::IsTrue(tree.kinds[left] == NodeKind::Identifier);
+            Assert::AreEqual(std::string("a"), std::string(tree.textOf(tree.text[left])));
+            Assert::IsTrue(tree.kinds[right] == NodeKind::Binary);
+            Assert::AreEqual(std::string("(a + (b * 2))"), toExpression(tree, root)->toString());
+        }
+
+        TEST_METHOD(FlatBlockChildren)
+        {
+            FlatTree tree;
+            FlatStatementParser parser(tokenize("{ x = 1; { y = 2; } z = 3; }"), FlatBuilder(tree));
+
+            NodeId root = parser.parse();
+
+            Assert::IsTrue(tree.kinds[root] == NodeKind::Block);
+            Assert::AreEqual(NodeId(3), tree.second[root]);
+            const NodeId* child = tree.blockBegin(root);
+            Assert::IsTrue(tree.kinds[child[0]] == NodeKind::Assignment);
+            Assert::IsTrue(tree.kinds[child[1]] == NodeKind::Block);
+            Assert::IsTrue(tree.kinds[child[2]] == NodeKind::Assignment);
+            Assert::AreEqual(std::string("z"), std::string(tree.textOf(tree.text[child[2]])));
+        }
+
+        TEST_METHOD(FlattenRoundTrip)
+        {
+            // Arrange
+            StatementParser parser(tokenize(program));
+            auto statements = parser.parseStatements();
+            auto expected = printAll(statements);
+
+            // Act
+            FlatTree tree = flatten(statements);
+            FlatTree copy = tree;
+
+            // Assert
+            Assert::AreEqual(statements.size(), tree.roots.size());
+            assertSamePrinted(expected, toStatements(copy));
+        }
+
+        TEST_METHOD(FlatParserErrors)
+        {
+            Assert::ExpectException<std::runtime_error>([]() {
+                FlatTree tree;
+                FlatStatementParser parser(tokenize("x++ = 1;"), FlatBuilder(tree));
+                parser.parseStatements();
+                });
+
+            Assert::ExpectException<std::runtime_error>([]() {
+                FlatTree tree;
+                FlatExpressionParser parser(tokenize("(1 + 2"), FlatBuilder(tree));
+                parser.parse();
+                });
+
+            Assert::ExpectException<std::runtime_error>([]() {
+                FlatTree tree;
+                FlatExpressionParser parser(tokenize("3++"), FlatBuilder(tree));
+                parser.parse();
+                });
+        }
+
+        TEST_METHOD(FlatNumbersKeepDecodedValue)
+        {
+            // Arrange
+            FlatTree tree;
+            FlatExpressionParser parser(tokenize("12 + 0.5"), FlatBuilder(tree));
+
+            // Act
+            NodeId root = parser.parse();
+            auto expr = toExpression(tree, root);
+
+            // Assert
+            Assert::AreEqual(size_t(2), tree.numbers.size());
+            Assert::AreEqual(std::int64_t(12), tree.numbers[tree.first[tree.first[root]]].integer);
+            auto right = nodeAs<NumberLiteral>(*nodeAs<BinaryOperation>(*expr)->right);
+            Assert::IsFalse(right->number.isInteger);
+            Assert::AreEqual(0.5, right->number.real);
+            Assert::AreEqual(std::string("0.5"), std::string(right->value));
+        }
+
+        TEST_METHOD(FlatStringsKeepDecodedContents)
+        {
+            // Arrange
+            FlatTree tree;
+            FlatExpressionParser parser(tokenize(R"("plain" + "a\tb")"), FlatBuilder(tree));
+
+            // Act
+            NodeId root = parser.parse();
+            NodeId plain = tree.first[root];
+            NodeId escaped = tree.second[root];
+
+            // Assert: contents without escapes share the spelling's bytes
+            Assert::AreEqual(std::string("plain"), std::string(tree.textOf(tree.text2[plain])));
+            Assert::AreEqual(tree.text[plain].offset + 1, tree.text2[plain].offset);
+            Assert::AreEqual(std::string("a\tb"), std::string(tree.textOf(tree.text2[escaped])));
+
+            auto expr = toExpression(tree, root);
+            auto right = nodeAs<StringLiteral>(*nodeAs<BinaryOperation>(*expr)->right);
+            Assert::AreEqual(std::string("a\tb"), std::string(right->decoded));
+        }
+
+
+        TEST_METHOD(DeepFlatTreesConvertWithoutRecursion)
+        {
+            // Arrange: nesting far deeper than a recursive conversion survives
+            const size_t depth = 100000;
+            FlatTree tree;
+            FlatBuilder builder(tree);
+            NodeId expr = builder.identifier("x");
+            for (size_t i = 0; i < depth; ++i) {
+                expr = i % 2 ? builder.unary(TokenKind::Minus, expr) : builder.binary(builder.number("1", NumberValue()), TokenKind::Plus, expr);
+            }
+            NodeId stmt = builder.expressionStatement(expr);
+            for (size_t i = 0; i < depth; ++i) {
+                stmt = i % 2 ? builder.block({ stmt }) : builder.ifStatement(builder.boolean(true), stmt, NoNode);
+            }
+
+            // Act
+            auto converted = toStatement(tree, stmt);
+
+            // Assert: walk down the same shape
+            const Statement* node = converted.get();
+            for (size_t i = depth; i-- > 0; ) {
+                if (i % 2) {
+                    auto block = nodeAs<Block>(*node);
+                    Assert::AreEqual(size_t(1), block->statements.size());
+                    node = block->statements[0].get();
+                }
+                else {
+                    auto branch = nodeAs<IfStatement>(*node);
+                    Assert::IsTrue(nodeAs<BooleanLiteral>(*branch->condition)->value);
+                    Assert::IsTrue(branch->elseStatement == nullptr);
+                    node = branch->thenStatement.get();
+                }
+            }
+            const Expression* value = nodeAs<ExpressionStatement>(*node)->expression.get();
+            for (size_t i = depth; i-- > 0; ) {
+                if (i % 2) {
+                    value = nodeAs<UnaryOperation>(*value)->operand.get();
+                }
+                else {
+                    auto binary = nodeAs<BinaryOperation>(*value);
+                    Assert::IsNotNull(nodeAs<NumberLiteral>(*binary->left));
+                    value = binary->right.get();
+                }
+            }
+            Assert::IsTrue(nodeAs<Identifier>(*value)->name == Symbol::intern("x"));
+        }
+
+        TEST_METHOD(FlatConversionChecksNodeKinds)
+        {
+            FlatTree tree;
+            FlatBuilder builder(tree);
+            NodeId expr = builder.identifier("x");
+            NodeId block = builder.block({ builder.expressionStatement(expr) });
+            NodeId nested = builder.unary(TokenKind::Minus, block);
+
+            Assert::ExpectException<std::runtime_error>([&]() { toStatement(tree, expr); });
+            Assert::ExpectException<std::runtime_error>([&]() { toExpression(tree, block); });
+            Assert::ExpectException<std::runtime_error>([&]() { toExpression(tree, nested); });
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../src/Tokenizer.h"
+#include "../src/StatementParser.h"
+#include "../src/Printer.h"
+#include "../src/Printer.cpp"
+#include <sstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lexer;
+using namespace Parser;
+using namespace AST;
+
+namespace PrinterTests
+{
+    TEST_CLASS(PrinterTests)
+    {
+    private:
+        std::vector<StatementPtr> parseProgram(const std::string& input) {
+            StatementParser parser(tokenize(input));
+            return parser.parseStatements();
+        }
+
+    public:
+
+        TEST_METHOD(PrintNestedBlocksDefaultLayout)
+        {
+            auto statements = parseProgram("{ x = 1; { y = 2; } }");
+
+            // Every statement line is indented once, whatever the depth
+            Assert::AreEqual(std::string("{\n  x = 1;\n  {\n  y = 2;\n}\n}"), statements[0]->toString());
+        }
+
+        TEST_METHOD(PrintAppendsToReusedBuffer)
+        {
+            // Arrange
+            auto statements = parseProgram("number x = -5; if (x > 0 or not y) { x--; } else ++x; word s = \"hi\";");
+            std::string expected;
+            for (const auto& stmt : statements) {
+                expected += stmt->toString() + "\n";
+            }
+
+            // Act
+            std::string buffer;
+            Printer printer(buffer);
+            for (const auto& stmt : statements) {
+                printer.print(*stmt);
+                buffer += '\n';
+            }
+
+            // Assert
+            Assert::AreEqual(expected, buffer);
+            Assert::AreEqual(std::string("if (((x > 0) or (not y))) {\n  (x--);\n} else (++x);"), statements[1]->toString());
+        }
+
+        TEST_METHOD(PrintToStream)
+        {
+            // Arrange: enough output to cross the stream flush threshold
+            std::string source;
+            for (int i = 0; i < 5000; ++i) {
+                source += "{ value" + std::to_string(i) + " = (a + b) * c - d / e; }\n";
+            }
+            auto statements = parseProgram(source);
+
+            std::string expected;
+            for (const auto& stmt : statements) {
+                expected += toString(*stmt);
+            }
+
+            // Act
+            std::ostringstream stream;
+            {
+                Printer printer(stream);
+                for (const auto& stmt : statements) {
+                    printer.print(*stmt);
+                }
+            }
+
+            // Assert
+            Assert::IsTrue(expected.size() > Printer::StreamFlushSize);
+            Assert::AreEqual(expected, stream.str());
+
+            std::ostringstream single;
+            single << *statements[0];
+            Assert::AreEqual(statements[0]->toString(), single.str());
+        }
+
+        TEST_METHOD(PrintIndentedBlocks)
+        {
+            auto statements = parseProgram("{ x = 1; { y = 2; if (a) { z = 3; } else w = 4; } }");
+
+            PrintOptions options;
+            options.indentBlocks = true;
+            std::string printed = toString(*statements[0], options);
+
+            Assert::AreEqual(std::string(
+                "{\n"
+                "  x = 1;\n"
+                "  {\n"
+                "    y = 2;\n"
+                "    if (a) {\n"
+                "      z = 3;\n"
+                "    } else w = 4;\n"
+                "  }\n"
+                "}"), printed);
+
+            options.indentWidth = 4;
+            Assert::AreEqual(std::string("{\n    {\n        y = 1;\n    }\n}"),
+                toString(*parseProgram("{ { y = 1; } }")[0], options));
+        }
+
+
+        TEST_METHOD(PrintPastRecursionLimit)
+        {
+            // Arrange: blocks nested deeper than the printer recurses, each with an if inside
+            const size_t depth = Printer::RecursionLimit * 2;
+            std::string source;
+            for (size_t i = 0; i < depth; ++i) {
+                source += "{ if (a) x = -(b + c); else ";
+            }
+            source += "y = 1;";
+            for (size_t i = 0; i < depth; ++i) {
+                source += " }";
+            }
+
+            ParseOptions parseOptions;
+            parseOptions.explicitStack = true;
+            StatementParser parser(tokenize(source));
+            parser.setOptions(parseOptions);
+            auto statements = parser.parseStatements();
+
+            PrintOptions options;
+            options.indentBlocks = true;
+
+            // Act
+            std::string printed = toString(*statements[0], options);
+
+            // Assert: the innermost block is indented by its full depth
+            std::string innermost = std::string(depth * 2, ' ') + "if (a) x = (- (b + c)); else y = 1;\n"
+                + std::string((depth - 1) * 2, ' ') + "}\n";
+            Assert::IsTrue(printed.find(innermost) != std::string::npos);
+            std::string outermost = "{\n  if (a) x = (- (b + c)); else {\n";
+            Assert::AreEqual(outermost, printed.substr(0, outermost.size()));
+        }
+    };
+}
\ No newline at end of file
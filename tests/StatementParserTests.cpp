@@ -2,20 +2,73 @@
 #include "CppUnitTest.h"
 #include "../src/Tokenizer.h"
 #include "../src/StatementParser.h"
+#include "../src/Visitor.h"
 #include "../src/StatementParser.cpp"
+#include "../src/ParallelParser.h"
+#include "../src/ParallelParser.cpp"
+#include "../src/Document.h"
+#include "../src/Document.cpp"
+#include "../src/ParseCache.h"
+#include "../src/ParseCache.cpp"
+#include <atomic>
+#include <thread>
+#include <type_traits>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Lexer;
+using namespace Util;
 using namespace Parser;
 using namespace AST;
 
 namespace StatementParserTests
 {
+    // Collects the names assigned or declared anywhere in a program
+    struct AssignedNames : Visitor<AssignedNames> {
+        std::vector<std::string> names;
+
+        void visitVariableDeclaration(const VariableDeclaration& node) { names.emplace_back(node.name); }
+        void visitAssignment(const AssignmentStatement& node) { names.emplace_back(node.variable); }
+        void visitDefault(const ASTNode& node) { visitChildren(node); }
+    };
+
+    // A document matches lexing and parsing its whole source from scratch
+    void assertMatchesFullParse(const Document& document) {
+        std::string source = document.source();
+        std::vector<PackedToken> packed;
+        Error lexError;
+        tokenizeInto(source, packed, lexError);
+
+        std::vector<Token> tokens;
+        for (const auto& token : packed) {
+            if (token.type != TokenType::Comment) {
+                tokens.emplace_back(token.type, std::string(token.text(source)), token.kind, token.offset);
+            }
+        }
+        Assert::AreEqual(static_cast<int>(lexError.code), static_cast<int>(document.lexError().code));
+        auto documentTokens = document.tokens();
+        Assert::AreEqual(tokens.size(), documentTokens.size());
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            Assert::AreEqual(tokens[i].offset, documentTokens[i].offset);
+            Assert::AreEqual(std::string(tokens[i].text()), std::string(documentTokens[i].text()));
+        }
+
+        StatementParser parser(tokens);
+        auto full = parser.tryParseStatements();
+        auto statements = document.statements();
+        Assert::AreEqual(full && !lexError, document.diagnostics().empty());
+        if (full && !lexError) {
+            Assert::AreEqual(full.value.size(), statements.size());
+            for (size_t i = 0; i < statements.size(); ++i) {
+                Assert::AreEqual(full.value[i]->toString(), statements[i]->toString());
+            }
+        }
+    }
+
     TEST_CLASS(StatementParserTests)
     {
     private:
         // Helper for single-statement tests
-        std::unique_ptr<Statement> parseStatement(const std::string& input) {
+        StatementPtr parseStatement(const std::string& input) {
             auto tokens = tokenize(input);
             StatementParser parser(tokens);
             return parser.parse();
@@ -262,5 +315,658 @@ namespace StatementParserTests
             Assert::IsTrue(result.find("if ((x > y))") != std::string::npos);
             Assert::IsTrue(result.find("else") != std::string::npos);
         }
+
+        TEST_METHOD(ParseStatementsFromLazyTokenSource)
+        {
+            std::string input = "number x = 5; x = x + 1; if (x > 5) { x = 0; } else x++;";
+            StringTokenSource source(input);
+            StatementParser parser(source);
+
+            auto statements = parser.parseStatements();
+            Assert::AreEqual(size_t(3), statements.size());
+            Assert::AreEqual(std::string("number x = 5;"), statements[0]->toString());
+            Assert::AreEqual(std::string("x = (x + 1);"), statements[1]->toString());
+            Assert::AreEqual(std::string("if ((x > 5)) {\n  x = 0;\n} else (x++);"), statements[2]->toString());
+        }
+
+        TEST_METHOD(ParseError_TrailingTokensInExpression)
+        {
+            Assert::ExpectException<std::runtime_error>([this]() {
+                parseStatement("x = 5 6;");
+                });
+
+            Assert::ExpectException<std::runtime_error>([this]() {
+                parseStatement("number y = (1 + 2;");
+                });
+
+            Assert::ExpectException<std::runtime_error>([this]() {
+                parseStatement("if (x > 5) ) x = 1;");
+                });
+        }
+
+
+        // Arena allocation
+        TEST_METHOD(ParseStatementsIntoArena)
+        {
+            std::string input = "number x = 5; if (x > 5) { x = 0; word s = \"a long string literal value\"; } else x++;";
+            auto tokens = tokenize(input);
+            Arena arena;
+
+            std::vector<StatementPtr> statements;
+            {
+                ArenaScope scope(arena);
+                StatementParser parser(tokens);
+                statements = parser.parseStatements();
+            }
+
+            Assert::AreEqual(size_t(2), statements.size());
+            Assert::IsTrue(statements[1]->inArena());
+            Assert::IsTrue(arena.bytesAllocated() > 0);
+            Assert::AreEqual(std::string("number x = 5;"), statements[0]->toString());
+            Assert::AreEqual(std::string("if ((x > 5)) {\n  x = 0;\n  word s = \"a long string literal value\";\n} else (x++);"),
+                statements[1]->toString());
+
+            // Dropping arena nodes is a no-op; the arena frees them all at once
+            statements.clear();
+            arena.release();
+            Assert::AreEqual(size_t(0), arena.bytesAllocated());
+
+            // Outside the scope nodes go back to the heap
+            auto stmt = parseStatement("x = 1;");
+            Assert::IsFalse(stmt->inArena());
+        }
+
+
+        TEST_METHOD(VisitorWalksStatements)
+        {
+            auto tokens = tokenize("number x = 1; if (x > 0) { y = 2; { z = 3; } } else w = 4; x++;");
+            StatementParser parser(tokens);
+            auto statements = parser.parseStatements();
+
+            AssignedNames visitor;
+            for (const auto& stmt : statements) {
+                visitor.visit(*stmt);
+            }
+
+            std::vector<std::string> expected = { "x", "y", "z", "w" };
+            Assert::AreEqual(expected.size(), visitor.names.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                Assert::AreEqual(expected[i], visitor.names[i]);
+            }
+        }
+
+
+        TEST_METHOD(ExplicitStackMatchesRecursiveStatements)
+        {
+            // Arrange
+            std::string input =
+                "number x = 1; { x = 2; { } if (x) y++; else { z = 3; } } "
+                "if (a) if (b) c = 1; else d = 2; word s; -x;";
+            auto tokens = tokenize(input);
+            ParseOptions options;
+            options.explicitStack = true;
+
+            // Act
+            StatementParser recursive(tokens);
+            StatementParser iterative(tokens);
+            iterative.setOptions(options);
+            auto expected = recursive.parseStatements();
+            auto actual = iterative.parseStatements();
+
+            // Assert
+            Assert::AreEqual(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                Assert::AreEqual(expected[i]->toString(), actual[i]->toString());
+            }
+
+            for (const char* bad : { "{ x = 1;", "if (x { }", "if (x) ", "{ number = 1; }" }) {
+                auto badTokens = tokenize(bad);
+                std::string recursiveError, iterativeError;
+                try { StatementParser(badTokens).parseStatements(); } catch (const std::runtime_error& e) { recursiveError = e.what(); }
+
+                StatementParser parser(badTokens);
+                parser.setOptions(options);
+                try { parser.parseStatements(); } catch (const std::runtime_error& e) { iterativeError = e.what(); }
+
+                Assert::IsFalse(recursiveError.empty());
+                Assert::AreEqual(recursiveError, iterativeError);
+            }
+        }
+
+        TEST_METHOD(ParseDeeplyNestedStatements)
+        {
+            // Arrange
+            const size_t depth = 100000;
+            std::string blocks = std::string(depth, '{') + "x = 1;" + std::string(depth, '}');
+            std::string ifs;
+            for (size_t i = 0; i < depth; ++i) {
+                ifs += "if (a) ";
+            }
+            ifs += "b = 1; else c = 2;";
+
+            ParseOptions options;
+            options.explicitStack = true; // with no depth limit by default
+
+            // Act
+            StatementParser blockParser(tokenize(blocks));
+            blockParser.setOptions(options);
+            auto blockChain = blockParser.parseStatements();
+
+            StatementParser ifParser(tokenize(ifs));
+            ifParser.setOptions(options);
+            auto ifChain = ifParser.parseStatements();
+
+            // Assert: the trees print and free without recursion
+            Assert::AreEqual(size_t(1), blockChain.size());
+            Assert::AreEqual(size_t(1), ifChain.size());
+            Assert::IsTrue(blockChain[0]->toString().find("x = 1;") != std::string::npos);
+            Assert::IsTrue(ifChain[0]->toString().find("b = 1; else c = 2;") != std::string::npos);
+
+            // A limit rejects the same input in either mode
+            for (bool explicitStack : { false, true }) {
+                ParseOptions limited;
+                limited.explicitStack = explicitStack;
+                limited.maxDepth = ParseOptions::DefaultMaxDepth;
+                StatementParser parser(tokenize(blocks));
+                parser.setOptions(limited);
+                try {
+                    parser.parseStatements();
+                    Assert::Fail(L"Expected nesting limit error");
+                }
+                catch (const std::runtime_error& e) {
+                    Assert::AreEqual(std::string("Nesting too deep (limit is 256)"), std::string(e.what()));
+                }
+            }
+        }
+
+
+        TEST_METHOD(TryParseStatementsReportsFirstError)
+        {
+            // Arrange
+            std::string input = "number x = 1;\nif (x > 0 { x = 2; }\ny = ;";
+
+            // Act
+            auto result = StatementParser(tokenize(input)).tryParseStatements();
+
+            // Assert
+            Assert::IsFalse(static_cast<bool>(result));
+            Assert::IsTrue(result.error.code == ErrorCode::ExpectedToken);
+            Assert::AreEqual(std::uint64_t(24), result.error.offset); // the '{'
+            Assert::AreEqual(std::string("Expected ')' after if condition. Got: '{'"), result.error.message());
+            Assert::IsTrue(result.value.empty());
+
+            auto missingName = StatementParser(tokenize("number = 1;")).tryParse();
+            Assert::IsTrue(missingName.error.code == ErrorCode::ExpectedTokenType);
+            Assert::AreEqual(std::string("Expected variable name. Got: '=' (type: 4)"), missingName.error.message());
+
+            auto atEnd = StatementParser(tokenize("x = 1")).tryParse();
+            Assert::IsTrue(atEnd.error.atEnd);
+            Assert::AreEqual(std::uint64_t(5), atEnd.error.offset);
+            Assert::AreEqual(std::string("Expected ';' after assignment. Got: end of input"), atEnd.error.message());
+
+            auto ok = StatementParser(tokenize("{ a = 1; b = 2; }")).tryParseStatements();
+            Assert::IsTrue(static_cast<bool>(ok));
+            Assert::AreEqual(size_t(1), ok.value.size());
+        }
+
+
+        TEST_METHOD(ParseProgramReportsEveryError)
+        {
+            // Arrange: three broken statements among four good ones
+            std::string input =
+                "number x = 1;\n"
+                "x = ;\n"
+                "if (x > 0 { y = 1; }\n"
+                "word s = \"ok\";\n"
+                "number = 2;\n"
+                "z = 3;";
+
+            for (bool explicitStack : { false, true }) {
+                ParseOptions options;
+                options.explicitStack = explicitStack;
+                StatementParser parser(tokenize(input));
+                parser.setOptions(options);
+
+                // Act
+                auto program = parser.parseProgram();
+
+                // Assert
+                Assert::IsFalse(program.ok());
+                Assert::AreEqual(size_t(3), program.diagnostics.size());
+                Assert::IsTrue(program.diagnostics[0].code == ErrorCode::UnexpectedToken);
+                Assert::AreEqual(std::uint64_t(18), program.diagnostics[0].offset);
+                Assert::IsTrue(program.diagnostics[1].code == ErrorCode::ExpectedToken);
+                Assert::IsTrue(program.diagnostics[2].code == ErrorCode::ExpectedTokenType);
+
+                Assert::AreEqual(size_t(4), program.statements.size());
+                Assert::AreEqual(std::string("number x = 1;"), program.statements[0]->toString());
+                Assert::AreEqual(std::string("{\n  y = 1;\n}"), program.statements[1]->toString());
+                Assert::AreEqual(std::string("word s = \"ok\";"), program.statements[2]->toString());
+                Assert::AreEqual(std::string("z = 3;"), program.statements[3]->toString());
+            }
+        }
+
+        TEST_METHOD(ParseProgramRecoversInsideBlocks)
+        {
+            const char* inputs[] = {
+                "{ a = 1; b = ; if (c) { d = (1; } e = 2; } f = 3;",
+                "{ { x = 1;",
+                "} a = 1; ) else b = 2; c = 3;",
+            };
+
+            for (bool explicitStack : { false, true }) {
+                ParseOptions options;
+                options.explicitStack = explicitStack;
+                std::vector<Program<StatementPtr>> programs;
+                for (const char* input : inputs) {
+                    StatementParser parser(tokenize(input));
+                    parser.setOptions(options);
+                    programs.push_back(parser.parseProgram());
+                }
+
+                // Each block keeps its good statements, at every depth
+                Assert::AreEqual(size_t(2), programs[0].diagnostics.size());
+                Assert::AreEqual(size_t(2), programs[0].statements.size());
+                Assert::AreEqual(std::string("{\n  a = 1;\n  if (c) {\n}\n  e = 2;\n}"), programs[0].statements[0]->toString());
+
+                // Unclosed blocks at the end of input are reported once
+                Assert::AreEqual(size_t(1), programs[1].diagnostics.size());
+                Assert::AreEqual(std::string("Expected '}' after block. Got: end of input"), programs[1].diagnostics[0].message());
+
+                // A stray '}' is skipped alone; other bad tokens up to the next ';'
+                Assert::AreEqual(size_t(2), programs[2].diagnostics.size());
+                Assert::AreEqual(size_t(2), programs[2].statements.size());
+                Assert::AreEqual(std::string("a = 1;"), programs[2].statements[0]->toString());
+                Assert::AreEqual(std::string("c = 3;"), programs[2].statements[1]->toString());
+            }
+
+            // A lexical error in a lazily lexed program ends it with a diagnostic
+            std::string lazyInput = "a = 1; b = ; c = \"open";
+            StringTokenSource source(lazyInput);
+            auto program = StatementParser(source).parseProgram();
+            Assert::AreEqual(size_t(2), program.diagnostics.size());
+            Assert::IsTrue(program.diagnostics[1].code == ErrorCode::UnterminatedString);
+            Assert::AreEqual(size_t(1), program.statements.size());
+        }
+
+        TEST_METHOD(ParseCommentedProgram)
+        {
+            // Arrange
+            std::string input =
+                "// totals\n"
+                "number x = 1; /* start */\n"
+                "if (x > 0) { /* positive */ x = x - 1; } // done\n";
+
+            // Act
+            StatementParser parser(tokenize(input));
+            auto statements = parser.parseStatements();
+
+            std::vector<Trivia> trivia;
+            StringTokenSource lazy(input, &trivia);
+            auto lazyStatements = StatementParser(lazy).parseStatements();
+
+            // Assert: the lazy source records the same trivia as tokenize()
+            Assert::AreEqual(size_t(2), statements.size());
+            Assert::AreEqual(size_t(2), lazyStatements.size());
+            Assert::AreEqual(statements[1]->toString(), lazyStatements[1]->toString());
+
+            std::vector<Trivia> expected;
+            tokenize(input, expected);
+            Assert::AreEqual(size_t(4), trivia.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                Assert::AreEqual(expected[i].token, trivia[i].token);
+                Assert::AreEqual(expected[i].offset, trivia[i].offset);
+                Assert::AreEqual(expected[i].length, trivia[i].length);
+            }
+        }
+
+        TEST_METHOD(SplitTopLevelStatements)
+        {
+            auto tokens = tokenize("if (a) { b = 1; } else c = 2; d = (1); { e; } f;");
+
+            auto starts = splitTopLevel(tokens, 1);
+
+            // Never before 'else', never inside brackets
+            Assert::AreEqual(size_t(4), starts.size());
+            Assert::AreEqual(std::string("d"), std::string(tokens[starts[1]].text()));
+            Assert::AreEqual(std::string("{"), std::string(tokens[starts[2]].text()));
+            Assert::AreEqual(std::string("f"), std::string(tokens[starts[3]].text()));
+        }
+
+        TEST_METHOD(ThreadPoolRunsEveryIndexOnce)
+        {
+            ThreadPool pool(4);
+            std::vector<std::atomic<int>> runs(1000);
+
+            pool.forEach(runs.size(), [&](size_t i) { runs[i]++; });
+            pool.forEach(runs.size(), [&](size_t i) { runs[i]++; });
+
+            for (auto& count : runs) {
+                Assert::AreEqual(2, count.load());
+            }
+            Assert::ExpectException<std::logic_error>([&]() {
+                pool.forEach(10, [](size_t i) { if (i == 7) throw std::logic_error("job failed"); });
+            });
+        }
+
+        TEST_METHOD(ParallelParseMatchesSequential)
+        {
+            // Arrange: enough statements for several chunks, with an error near the end
+            std::string input;
+            for (int i = 0; i < 600; ++i) {
+                std::string n = std::to_string(i);
+                input += "number v" + n + " = (a + " + n + ") * 2;\n";
+                input += "if (v" + n + " > 3) { v" + n + " = 0; count++; } else v" + n + "--;\n";
+                input += "{ word s = \"text\"; if (s) { t = s; } }\n";
+            }
+            std::string broken = input + "x = ;\n" + input.substr(0, 400) + "y = 1;";
+            auto good = tokenize(input);
+            auto bad = tokenize(broken);
+
+            for (size_t threads : { 1, 3 }) {
+                ThreadPool pool(threads);
+
+                // Act
+                auto sequential = StatementParser(good).parseProgram();
+                auto parallel = parseProgramParallel(good, pool);
+                auto sequentialBad = StatementParser(bad).parseProgram();
+                auto parallelBad = parseProgramParallel(bad, pool);
+
+                // Assert
+                Assert::IsTrue(splitTopLevel(good, 1024).size() > 3);
+                Assert::IsTrue(parallel.ok());
+                Assert::AreEqual(sequential.statements.size(), parallel.statements.size());
+                for (size_t i = 0; i < sequential.statements.size(); ++i) {
+                    Assert::AreEqual(sequential.statements[i]->toString(), parallel.statements[i]->toString());
+                }
+
+                Assert::AreEqual(sequentialBad.statements.size(), parallelBad.statements.size());
+                Assert::AreEqual(sequentialBad.diagnostics.size(), parallelBad.diagnostics.size());
+                for (size_t i = 0; i < sequentialBad.diagnostics.size(); ++i) {
+                    Assert::AreEqual(sequentialBad.diagnostics[i].message(), parallelBad.diagnostics[i].message());
+                    Assert::AreEqual(sequentialBad.diagnostics[i].offset, parallelBad.diagnostics[i].offset);
+                }
+                Assert::AreEqual(sequentialBad.statements.back()->toString(), parallelBad.statements.back()->toString());
+            }
+        }
+
+
+        TEST_METHOD(DocumentEditsMatchFullParse)
+        {
+            // Arrange
+            std::string text = "number a = 1;\nif (a > 0) { a = a + 1; }\nword s = \"hi\"; // note\nb = a * 2;\n";
+            Document document(text);
+            assertMatchesFullParse(document);
+
+            auto apply = [&](const std::string& find, size_t removed, const std::string& inserted) {
+                size_t at = document.source().find(find);
+                Assert::IsTrue(at != std::string::npos);
+                document.edit(at, removed, inserted);
+                assertMatchesFullParse(document);
+            };
+
+            // Act & Assert: each edit is checked against a parse from scratch
+            apply("a = 1", 1, "alpha");              // grow an identifier
+            apply("alpha", 5, "a");                  // and shrink it back
+            apply("1;\n", 1, "");                    // break a statement
+            apply(";\nif", 0, "1");                  // and mend it
+            apply("if", 0, "/* ");                   // open a comment across lines
+            apply("word", 0, "*/ ");                 // and close it
+            apply("/* ", 3, "");
+            apply("*/ ", 3, "");
+            apply("\"hi\"", 1, "");                  // unterminated string
+            apply("hi\"", 0, "\"");
+            apply("}\n", 1, "} else a = 0;");        // an else joins the if
+            apply("note", 4, "x\ny = 2;");           // line comment ends early
+            apply("b = a", 0, "{ ");                 // an unclosed block swallows the rest
+            apply("{ b", 2, "");
+            document.edit(0, 0, "c = 3;");
+            assertMatchesFullParse(document);
+            document.edit(document.source().size(), 0, "\nd = c;");
+            assertMatchesFullParse(document);
+            document.edit(0, document.source().size(), "");
+            assertMatchesFullParse(document);
+            Assert::IsTrue(document.statements().empty());
+        }
+
+        TEST_METHOD(DocumentEditReparsesOnlyNearbyStatements)
+        {
+            // Arrange
+            std::string text;
+            for (int i = 0; i < 1000; ++i) {
+                text += "v" + std::to_string(i) + " = " + std::to_string(i) + " + x;\n";
+            }
+            Document document(text);
+            auto before = document.statements();
+
+            // Act
+            size_t at = document.source().find("v500 =");
+            EditStats stats = document.edit(at + 1, 3, "alue");
+
+            // Assert
+            auto after = document.statements();
+            Assert::AreEqual(size_t(1), stats.tokensLexed);
+            Assert::IsTrue(stats.statementsParsed <= 2);
+            Assert::AreEqual(before.size(), after.size());
+            Assert::IsTrue(before[0] == after[0]);
+            Assert::IsTrue(before[999] == after[999]);
+            Assert::AreEqual(std::string("value"), std::string(document.tokens()[500 * 6].text()));
+            Assert::ExpectException<std::out_of_range>([&]() { document.edit(document.source().size(), 1, ""); });
+            assertMatchesFullParse(document);
+        }
+
+
+        TEST_METHOD(LazyBlocksParseOnFirstUse)
+        {
+            // Arrange
+            std::string input = "number a = 1; { b = 2; if (b) { c = 3; } } if (a) { d = 4; } else { e = 5; }";
+            auto tokens = tokenize(input);
+            ParseOptions options;
+            options.lazyBlocks = true;
+
+            for (bool explicitStack : { false, true }) {
+                options.explicitStack = explicitStack;
+
+                // Act
+                StatementParser eager(tokens);
+                auto expected = eager.parseStatements();
+                StatementParser parser(tokens);
+                parser.setOptions(options);
+                auto statements = parser.parseStatements();
+
+                // Assert: blocks are kept unparsed until something looks inside
+                Assert::AreEqual(size_t(3), statements.size());
+                auto block = nodeAs<LazyBlock>(*statements[1]);
+                Assert::IsNotNull(block);
+                Assert::IsFalse(block->parsed());
+                auto ifStatement = nodeAs<IfStatement>(*statements[2]);
+                Assert::IsTrue(ifStatement->thenStatement->kind == NodeKind::LazyBlock);
+
+                Assert::AreEqual(size_t(2), block->body().statements.size());
+                Assert::IsTrue(block->parsed());
+                Assert::IsTrue(block->body().statements[1]->kind == NodeKind::If);
+                Assert::IsFalse(nodeAs<LazyBlock>(*ifStatement->elseStatement)->parsed());
+
+                for (size_t i = 0; i < statements.size(); ++i) {
+                    Assert::AreEqual(expected[i]->toString(), statements[i]->toString());
+                }
+                Assert::IsTrue(nodeAs<LazyBlock>(*ifStatement->elseStatement)->parsed());
+            }
+        }
+
+        TEST_METHOD(LazyBlockErrorsSurfaceOnUse)
+        {
+            // Arrange
+            auto tokens = tokenize("{ x = ; } y = 1;");
+            auto unbalanced = tokenize("{ x = 1; { y = 2; }");
+            ParseOptions options;
+            options.lazyBlocks = true;
+
+            // Act
+            auto eager = StatementParser(tokens).tryParseStatements();
+            StatementParser parser(tokens);
+            parser.setOptions(options);
+            auto lazy = parser.tryParseStatements();
+            StatementParser unbalancedParser(unbalanced);
+            unbalancedParser.setOptions(options);
+
+            // Assert: only the braces are checked up front
+            Assert::IsFalse(static_cast<bool>(eager));
+            Assert::IsTrue(static_cast<bool>(lazy));
+            auto block = nodeAs<LazyBlock>(*lazy.value[0]);
+            Assert::IsNull(block->tryBody());
+            Assert::AreEqual(eager.error.message(), block->error().message());
+            Assert::AreEqual(eager.error.offset, block->error().offset);
+            Assert::ExpectException<SyntaxError>([&]() { block->body(); });
+            Assert::IsFalse(static_cast<bool>(unbalancedParser.tryParseStatements()));
+        }
+
+        TEST_METHOD(LazyBlockParsesOnceAcrossThreads)
+        {
+            // Arrange
+            std::string input = "{";
+            for (int i = 0; i < 200; ++i) {
+                input += " v" + std::to_string(i) + " = " + std::to_string(i) + " * 2; { w = v; }";
+            }
+            input += " }";
+            auto tokens = tokenize(input);
+            ParseOptions options;
+            options.lazyBlocks = true;
+            StatementParser parser(tokens);
+            parser.setOptions(options);
+            auto statement = parser.parse();
+            auto block = nodeAs<LazyBlock>(*statement);
+
+            // Act
+            std::vector<const Block*> bodies(4);
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < bodies.size(); ++t) {
+                threads.emplace_back([&, t]() { bodies[t] = &block->body(); });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            // Assert
+            for (const Block* body : bodies) {
+                Assert::IsTrue(body == bodies[0]);
+            }
+            Assert::AreEqual(size_t(400), bodies[0]->statements.size());
+            Assert::AreEqual(StatementParser(tokens).parse()->toString(), statement->toString());
+        }
+
+
+        TEST_METHOD(ParseCacheSharesResultsOfRepeatedText)
+        {
+            // Arrange
+            ParseCache cache(2);
+            std::string text = "if (x > 1) { y = 2; }";
+
+            // Act
+            auto first = cache.parse(text, ParseMode::Statement);
+            auto again = cache.parse(std::string(text), ParseMode::Statement);
+            auto asProgram = cache.parse(text, ParseMode::Statements);
+            auto expression = cache.parse("a + b * 2", ParseMode::Expression);
+            auto broken = cache.parse("x = ;", ParseMode::Statement);
+            auto evicted = cache.parse(text, ParseMode::Statement);
+
+            // Assert
+            Assert::IsTrue(first == again);
+            Assert::IsTrue(first != asProgram); // the mode is part of the key
+            Assert::AreEqual(StatementParser(tokenize(text)).parse()->toString(), first->statement(0).toString());
+            Assert::AreEqual(std::string("(a + (b * 2))"), expression->expression().toString());
+            Assert::IsFalse(broken->ok());
+            Assert::AreEqual(std::string("Unexpected token: ';'"), broken->error().message());
+
+            static_assert(std::is_same_v<decltype(first->statement(0)), const Statement&>, "shared trees are read-only");
+            static_assert(std::is_same_v<decltype(expression->expression()), const Expression&>, "shared trees are read-only");
+
+            Assert::IsTrue(evicted != first); // pushed out by the two parses after it
+            Assert::AreEqual(first->statement(0).toString(), evicted->statement(0).toString());
+            ParseCacheStats stats = cache.stats();
+            Assert::AreEqual(size_t(1), stats.hits);
+            Assert::AreEqual(size_t(5), stats.misses);
+            Assert::AreEqual(size_t(3), stats.evictions);
+            Assert::AreEqual(size_t(2), cache.size());
+        }
+
+        TEST_METHOD(ParseCacheIsSharedBetweenThreads)
+        {
+            // Arrange
+            ParseCache cache(8);
+            std::vector<std::string> texts;
+            for (int i = 0; i < 4; ++i) {
+                texts.push_back("number v" + std::to_string(i) + " = " + std::to_string(i) + ";");
+            }
+            AST::Arena arena;
+
+            // Act
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([&]() {
+                    AST::ArenaScope scope(arena); // cached trees still go to the heap
+                    for (int round = 0; round < 50; ++round) {
+                        Assert::IsTrue(cache.parse(texts[round % texts.size()], ParseMode::Statements)->ok());
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            // Assert
+            ParseCacheStats stats = cache.stats();
+            Assert::AreEqual(size_t(200), stats.hits + stats.misses);
+            Assert::IsTrue(stats.misses >= 4);
+            Assert::AreEqual(size_t(0), stats.evictions);
+            Assert::AreEqual(size_t(0), arena.bytesAllocated());
+            Assert::AreEqual(size_t(4), cache.size());
+            Assert::IsTrue(hashSource("abcdefghi") != hashSource("abcdefghj"));
+        }
+
+        TEST_METHOD(ParallelParseReportsErrorsInsideBlocks)
+        {
+            // Arrange
+            auto tokens = tokenize("{ x = ; } y = 1;");
+            ParseOptions options;
+            options.lazyBlocks = true;
+            ThreadPool pool(2);
+
+            // Act
+            auto sequential = StatementParser(tokens).parseProgram();
+            auto parallel = parseProgramParallel(tokens, pool, options);
+
+            // Assert: lazy blocks would hide the error until the body is used
+            Assert::AreEqual(size_t(1), sequential.diagnostics.size());
+            Assert::AreEqual(size_t(1), parallel.diagnostics.size());
+            Assert::AreEqual(sequential.diagnostics[0].message(), parallel.diagnostics[0].message());
+            Assert::AreEqual(sequential.statements.size(), parallel.statements.size());
+            Assert::IsTrue(parallel.statements[0]->kind == NodeKind::Block);
+        }
+
+        TEST_METHOD(ParallelParseIgnoresCallersArena)
+        {
+            // Arrange: several chunks, one of them broken
+            std::string input;
+            for (int i = 0; i < 2000; ++i) {
+                input += "{ a = " + std::to_string(i) + "; }\n";
+            }
+            auto tokens = tokenize(input + "x = ;");
+            ThreadPool pool(3);
+            Arena arena;
+
+            // Act
+            Program<StatementPtr> program;
+            {
+                ArenaScope scope(arena);
+                program = parseProgramParallel(tokens, pool);
+            }
+
+            // Assert: every node is on the heap, whichever thread parsed it
+            Assert::AreEqual(size_t(2000), program.statements.size());
+            for (const auto& statement : program.statements) {
+                Assert::IsFalse(statement->inArena());
+            }
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../src/Tokenizer.h"
+#include "../src/StreamLexer.h"
+#include "../src/StreamLexer.cpp"
+#include <sstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lexer;
+
+namespace StreamLexerTests
+{
+    TEST_CLASS(StreamLexerTests)
+    {
+    private:
+        std::vector<Token> lexStream(const std::string& input, size_t chunkSize) {
+            std::istringstream in(input);
+            StreamLexer lexer(in, chunkSize);
+
+            std::vector<Token> tokens;
+            Token token(TokenType::Unknown, "");
+            while (lexer.next(token)) {
+                tokens.push_back(token);
+            }
+            return tokens;
+        }
+
+        // tokenize() output with its comments put back in place, as the stream lexer emits them
+        std::vector<Token> tokenizeWithComments(const std::string& input) {
+            std::vector<Trivia> trivia;
+            auto tokens = tokenize(input, trivia);
+
+            std::vector<Token> all;
+            for (size_t i = 0; i <= tokens.size(); ++i) {
+                auto comments = triviaBefore(trivia, i);
+                for (const Trivia* comment = comments.first; comment != comments.second; ++comment) {
+                    all.emplace_back(TokenType::Comment, std::string(comment->text(input)), TokenKind::None, comment->offset);
+                }
+                if (i < tokens.size()) {
+                    all.push_back(tokens[i]);
+                }
+            }
+            return all;
+        }
+
+        void assertSameTokens(const std::string& input, size_t chunkSize) {
+            auto expected = tokenizeWithComments(input);
+            auto actual = lexStream(input, chunkSize);
+
+            Assert::AreEqual(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                Assert::AreEqual(static_cast<int>(expected[i].type), static_cast<int>(actual[i].type));
+                Assert::AreEqual(std::string(expected[i].text()), std::string(actual[i].text()));
+                Assert::AreEqual(expected[i].offset, actual[i].offset);
+            }
+        }
+
+    public:
+
+        TEST_METHOD(MatchesTokenizeForEveryChunkSize)
+        {
+            std::string input =
+                "number counter = 12.75; // trailing comment\n"
+                "word greeting = \"hello \\\"quoted\\\" world\";\n"
+                "/* a block\n comment */ if (counter >= 10 && flag != false) { counter += 1; }\n"
+                "identifier_with_long_name <<= 3";
+
+            for (size_t chunkSize = 1; chunkSize <= 16; ++chunkSize) {
+                assertSameTokens(input, chunkSize);
+            }
+            assertSameTokens(input, StreamLexer::DefaultChunkSize);
+        }
+
+        TEST_METHOD(ReportsAbsoluteOffsets)
+        {
+            std::istringstream in("  alpha   beta");
+            StreamLexer lexer(in, 3);
+
+            Assert::IsTrue(lexer.next());
+            Assert::AreEqual(std::uint64_t(2), lexer.offset());
+            Assert::IsTrue(lexer.text() == "alpha");
+
+            Assert::IsTrue(lexer.next());
+            Assert::AreEqual(std::uint64_t(10), lexer.offset());
+            Assert::IsTrue(lexer.text() == "beta");
+
+            Assert::IsFalse(lexer.next());
+        }
+
+        TEST_METHOD(EmptyAndWhitespaceOnlyInput)
+        {
+            Assert::AreEqual(size_t(0), lexStream("", 4).size());
+            Assert::AreEqual(size_t(0), lexStream("   \t\n   \n", 4).size());
+        }
+
+        TEST_METHOD(UnterminatedStringAcrossChunksThrows)
+        {
+            Assert::ExpectException<std::runtime_error>([this]() {
+                lexStream("x = \"never closed", 4);
+                });
+        }
+
+        TEST_METHOD(UnterminatedBlockCommentAcrossChunksThrows)
+        {
+            Assert::ExpectException<std::runtime_error>([this]() {
+                lexStream("x /* never closed", 4);
+                });
+        }
+
+        TEST_METHOD(UnrecognizedCharacterThrows)
+        {
+            Assert::ExpectException<std::runtime_error>([this]() {
+                lexStream("x = 1; @ y = 2;", 4);
+                });
+        }
+
+        TEST_METHOD(InputEndingOnAChunkBoundary)
+        {
+            // Arrange: the last token ends exactly where a chunk does
+            std::string unit = "alpha = beta + 12; ";
+            std::string input;
+            while (input.size() + unit.size() < StreamLexer::DefaultChunkSize) {
+                input += unit;
+            }
+            input += std::string(StreamLexer::DefaultChunkSize - input.size() - 1, ' ') + "z";
+
+            // Act / Assert
+            Assert::AreEqual(size_t(StreamLexer::DefaultChunkSize), input.size());
+            assertSameTokens(input, StreamLexer::DefaultChunkSize);
+            for (size_t chunkSize : { 1, 2, 4, 8 }) {
+                std::string small = "a = 1; bb = 22;";
+                small.resize(chunkSize * ((small.size() + chunkSize - 1) / chunkSize), ' ');
+                small.back() = 'c';
+                assertSameTokens(small, chunkSize);
+            }
+        }
+
+        TEST_METHOD(SingleByteChunksMatchTokenize)
+        {
+            std::string input =
+                "x=1;y+=x<<2;/*c*/word s=\"a\\\"b\";// end\n"
+                "if(x>=12.5){z--;}w";
+
+            assertSameTokens(input, 1);
+        }
+    };
+}
\ No newline at end of file
@@ -2,12 +2,21 @@
 #include "CppUnitTest.h"
 #include "../src/Tokenizer.h"
 #include "../src/Tokenizer.cpp"
+#include "../src/Scanner.h"
+#include "../src/Scanner.cpp"
+#include "../src/Symbol.h"
+#include "../src/Symbol.cpp"
+#include "../src/ParallelLexer.h"
+#include "../src/ParallelLexer.cpp"
+#include "../src/ThreadPool.cpp"
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include <thread>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Lexer;
+using namespace Util;
 
 namespace TokenizerTests
 {
@@ -26,15 +35,15 @@ namespace TokenizerTests
             // Assert
             Assert::AreEqual(size_t(5), tokens.size());
             Assert::AreEqual(static_cast<int>(TokenType::Keyword), static_cast<int>(tokens[0].type));
-            Assert::AreEqual(std::string("number"), tokens[0].value);
+            Assert::AreEqual(std::string("number"), std::string(tokens[0].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Identifier), static_cast<int>(tokens[1].type));
-            Assert::AreEqual(std::string("x"), tokens[1].value);
+            Assert::AreEqual(std::string("x"), std::string(tokens[1].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Operator), static_cast<int>(tokens[2].type));
-            Assert::AreEqual(std::string("="), tokens[2].value);
+            Assert::AreEqual(std::string("="), std::string(tokens[2].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Number), static_cast<int>(tokens[3].type));
-            Assert::AreEqual(std::string("10"), tokens[3].value);
+            Assert::AreEqual(std::string("10"), std::string(tokens[3].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Punctuation), static_cast<int>(tokens[4].type));
-            Assert::AreEqual(std::string(";"), tokens[4].value);
+            Assert::AreEqual(std::string(";"), std::string(tokens[4].text()));
         }
 
         TEST_METHOD(UnterminatedStringThrowsException)
@@ -64,19 +73,19 @@ namespace TokenizerTests
             // Assert
             Assert::AreEqual(size_t(11), tokens.size());
             Assert::AreEqual(static_cast<int>(TokenType::Keyword), static_cast<int>(tokens[0].type));
-            Assert::AreEqual(std::string("if"), tokens[0].value);
+            Assert::AreEqual(std::string("if"), std::string(tokens[0].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Punctuation), static_cast<int>(tokens[1].type));
-            Assert::AreEqual(std::string("("), tokens[1].value);
+            Assert::AreEqual(std::string("("), std::string(tokens[1].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Identifier), static_cast<int>(tokens[2].type));
-            Assert::AreEqual(std::string("x"), tokens[2].value);
+            Assert::AreEqual(std::string("x"), std::string(tokens[2].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Operator), static_cast<int>(tokens[3].type));
-            Assert::AreEqual(std::string(">"), tokens[3].value);
+            Assert::AreEqual(std::string(">"), std::string(tokens[3].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Number), static_cast<int>(tokens[4].type));
-            Assert::AreEqual(std::string("10"), tokens[4].value);
+            Assert::AreEqual(std::string("10"), std::string(tokens[4].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Punctuation), static_cast<int>(tokens[5].type));
-            Assert::AreEqual(std::string(")"), tokens[5].value);
+            Assert::AreEqual(std::string(")"), std::string(tokens[5].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Punctuation), static_cast<int>(tokens[6].type));
-            Assert::AreEqual(std::string("{"), tokens[6].value);
+            Assert::AreEqual(std::string("{"), std::string(tokens[6].text()));
         }
 
         TEST_METHOD(MultipleKeywordsAndIdentifiers)
@@ -90,19 +99,19 @@ namespace TokenizerTests
             // Assert
             Assert::AreEqual(size_t(9), tokens.size());
             Assert::AreEqual(static_cast<int>(TokenType::Keyword), static_cast<int>(tokens[0].type));
-            Assert::AreEqual(std::string("function"), tokens[0].value);
+            Assert::AreEqual(std::string("function"), std::string(tokens[0].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Identifier), static_cast<int>(tokens[1].type));
-            Assert::AreEqual(std::string("myFunc"), tokens[1].value);
+            Assert::AreEqual(std::string("myFunc"), std::string(tokens[1].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Punctuation), static_cast<int>(tokens[2].type));
-            Assert::AreEqual(std::string("("), tokens[2].value);
+            Assert::AreEqual(std::string("("), std::string(tokens[2].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Punctuation), static_cast<int>(tokens[3].type));
-            Assert::AreEqual(std::string(")"), tokens[3].value);
+            Assert::AreEqual(std::string(")"), std::string(tokens[3].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Punctuation), static_cast<int>(tokens[4].type));
-            Assert::AreEqual(std::string("{"), tokens[4].value);
+            Assert::AreEqual(std::string("{"), std::string(tokens[4].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Keyword), static_cast<int>(tokens[5].type));
-            Assert::AreEqual(std::string("return"), tokens[5].value);
+            Assert::AreEqual(std::string("return"), std::string(tokens[5].text()));
             Assert::AreEqual(static_cast<int>(TokenType::Keyword), static_cast<int>(tokens[6].type));
-            Assert::AreEqual(std::string("number"), tokens[6].value);
+            Assert::AreEqual(std::string("number"), std::string(tokens[6].text()));
         }
 
         TEST_METHOD(SingleKeyword)
@@ -116,7 +125,7 @@ namespace TokenizerTests
             // Assert
             Assert::AreEqual(size_t(1), tokens.size());
             Assert::AreEqual(static_cast<int>(TokenType::Keyword), static_cast<int>(tokens[0].type));
-            Assert::AreEqual(std::string("while"), tokens[0].value);
+            Assert::AreEqual(std::string("while"), std::string(tokens[0].text()));
         }
 
         TEST_METHOD(EmptyInputReturnsEmptyVector)
@@ -169,7 +178,7 @@ namespace TokenizerTests
             // Assert
             Assert::AreEqual(size_t(1), tokens.size());
             Assert::AreEqual(static_cast<int>(TokenType::Keyword), static_cast<int>(tokens[0].type));
-            Assert::AreEqual(std::string("if"), tokens[0].value);
+            Assert::AreEqual(std::string("if"), std::string(tokens[0].text()));
         }
 
         TEST_METHOD(KeywordRecognition_Function)
@@ -183,7 +192,7 @@ namespace TokenizerTests
             // Assert
             Assert::AreEqual(size_t(1), tokens.size());
             Assert::AreEqual(static_cast<int>(TokenType::Keyword), static_cast<int>(tokens[0].type));
-            Assert::AreEqual(std::string("function"), tokens[0].value);
+            Assert::AreEqual(std::string("function"), std::string(tokens[0].text()));
         }
 
         TEST_METHOD(IdentifierRecognition)
@@ -197,7 +206,7 @@ namespace TokenizerTests
             // Assert
             Assert::AreEqual(size_t(1), tokens.size());
             Assert::AreEqual(static_cast<int>(TokenType::Identifier), static_cast<int>(tokens[0].type));
-            Assert::AreEqual(std::string("myVariable"), tokens[0].value);
+            Assert::AreEqual(std::string("myVariable"), std::string(tokens[0].text()));
         }
 
         TEST_METHOD(NumberRecognition)
@@ -211,7 +220,403 @@ namespace TokenizerTests
             // Assert
             Assert::AreEqual(size_t(1), tokens.size());
             Assert::AreEqual(static_cast<int>(TokenType::Number), static_cast<int>(tokens[0].type));
-            Assert::AreEqual(std::string("123"), tokens[0].value);
+            Assert::AreEqual(std::string("123"), std::string(tokens[0].text()));
+        }
+
+        TEST_METHOD(PackedTokensReferenceSource)
+        {
+            // Arrange
+            std::string input = "number total = price * 2.5; // note";
+
+            // Act
+            auto buffer = tokenizePacked(input);
+
+            // Assert
+            Assert::AreEqual(size_t(8), buffer.size());
+            Assert::AreEqual(static_cast<int>(TokenType::Keyword), static_cast<int>(buffer[0].type));
+            Assert::IsTrue(buffer.text(0) == "number");
+            Assert::IsTrue(buffer.text(1) == "total");
+            Assert::AreEqual(size_t(7), size_t(buffer[1].offset));
+            Assert::AreEqual(size_t(5), size_t(buffer[1].length));
+            Assert::IsTrue(buffer.text(5) == "2.5");
+            Assert::AreEqual(static_cast<int>(TokenType::Comment), static_cast<int>(buffer[7].type));
+            Assert::IsTrue(buffer.text(7) == "// note");
+        }
+
+        TEST_METHOD(PackedTokensMatchTokenize)
+        {
+            // Arrange
+            std::string input = "if (x >= 10 && y != \"a\\\"b\") { x += 1; } /* done */";
+
+            // Act
+            std::vector<Trivia> trivia;
+            auto tokens = tokenize(input, trivia);
+            std::vector<PackedToken> packed;
+            tokenizeInto(input, packed);
+
+            // Assert: packed tokens keep the comment that tokenize() moves to trivia
+            Assert::AreEqual(tokens.size() + 1, packed.size());
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                Assert::AreEqual(static_cast<int>(tokens[i].type), static_cast<int>(packed[i].type));
+                Assert::AreEqual(std::string(tokens[i].text()), std::string(packed[i].text(input)));
+            }
+            Assert::AreEqual(size_t(1), trivia.size());
+            Assert::AreEqual(tokens.size(), trivia[0].token);
+            Assert::AreEqual(std::string(packed.back().text(input)), std::string(trivia[0].text(input)));
+        }
+
+        TEST_METHOD(VectorScannersMatchScalar)
+        {
+            // Arrange: every byte value, at every alignment and length
+            std::string input;
+            for (int round = 0; round < 3; ++round) {
+                for (int c = 0; c < 256; ++c) {
+                    input += static_cast<char>(c);
+                    input += std::string(c % 40, c % 3 == 0 ? ' ' : 'a');
+                }
+            }
+            input += "  \t\r\n  abc_123  \"str\\\"ing\" // line\n /* block ** */ 42.5";
+
+            ScanLevel original = scanLevel();
+            std::vector<ScanLevel> levels = { ScanLevel::Scalar, ScanLevel::SSE2, ScanLevel::AVX2 };
+
+            // Act & Assert
+            for (size_t pos = 0; pos < input.size(); pos += 7) {
+                std::vector<size_t> expected;
+                for (ScanLevel level : levels) {
+                    setScanLevel(level);
+                    std::vector<size_t> actual = {
+                        skipWhitespace(input, pos), skipIdentifier(input, pos), skipDigits(input, pos),
+                        findStringDelimiter(input, pos), findLineEnd(input, pos), findBlockCommentEnd(input, pos)
+                    };
+                    if (expected.empty()) {
+                        expected = actual;
+                    }
+                    for (size_t i = 0; i < expected.size(); ++i) {
+                        Assert::AreEqual(expected[i], actual[i]);
+                    }
+                }
+            }
+
+            setScanLevel(original);
+        }
+
+        TEST_METHOD(TokenizeSameAtEveryScanLevel)
+        {
+            // Arrange
+            std::string input;
+            for (int i = 0; i < 50; ++i) {
+                input += "number value_" + std::to_string(i) + " = " + std::to_string(i * 1234) + ".5;    \n";
+                input += "/* block comment with * stars ** and / slashes */ word s = \"esc \\\" \\\\ aped\";\n";
+                input += "// line comment\t\t\n";
+            }
+
+            ScanLevel original = scanLevel();
+            setScanLevel(ScanLevel::Scalar);
+            auto expected = tokenize(input);
+
+            // Act & Assert
+            for (ScanLevel level : { ScanLevel::SSE2, ScanLevel::AVX2 }) {
+                setScanLevel(level);
+                auto actual = tokenize(input);
+                Assert::AreEqual(expected.size(), actual.size());
+                for (size_t i = 0; i < expected.size(); ++i) {
+                    Assert::AreEqual(static_cast<int>(expected[i].type), static_cast<int>(actual[i].type));
+                    Assert::AreEqual(std::string(expected[i].text()), std::string(actual[i].text()));
+                }
+            }
+
+            setScanLevel(original);
+        }
+
+        TEST_METHOD(KeywordsCarryTheirOwnKind)
+        {
+            // Arrange
+            std::string input = "if else while protected iffy Number";
+
+            // Act
+            auto tokens = tokenize(input);
+
+            // Assert
+            Assert::AreEqual(size_t(6), tokens.size());
+            Assert::AreEqual(static_cast<int>(TokenKind::KwIf), static_cast<int>(tokens[0].kind));
+            Assert::AreEqual(static_cast<int>(TokenKind::KwElse), static_cast<int>(tokens[1].kind));
+            Assert::AreEqual(static_cast<int>(TokenKind::KwWhile), static_cast<int>(tokens[2].kind));
+            Assert::AreEqual(static_cast<int>(TokenKind::KwProtected), static_cast<int>(tokens[3].kind));
+            Assert::AreEqual(static_cast<int>(TokenType::Identifier), static_cast<int>(tokens[4].type));
+            Assert::AreEqual(static_cast<int>(TokenKind::None), static_cast<int>(tokens[4].kind));
+            Assert::AreEqual(static_cast<int>(TokenType::Identifier), static_cast<int>(tokens[5].type));
+        }
+
+        TEST_METHOD(EveryKeywordIsRecognized)
+        {
+            for (size_t i = 0; i < KeywordCount; ++i) {
+                auto tokens = tokenize(std::string(keywordSpellings[i]));
+                Assert::AreEqual(size_t(1), tokens.size());
+                Assert::AreEqual(static_cast<int>(TokenType::Keyword), static_cast<int>(tokens[0].type));
+                Assert::IsTrue(keywordText(tokens[0].kind) == keywordSpellings[i]);
+            }
+        }
+
+        TEST_METHOD(OperatorsUseLongestMatch)
+        {
+            // Arrange
+            std::string input = "a <<= b >>= c << d >= e ++ = ! != ;";
+
+            // Act
+            auto tokens = tokenize(input);
+
+            // Assert
+            std::vector<TokenKind> expected = {
+                TokenKind::None, TokenKind::ShiftLeftAssign, TokenKind::None, TokenKind::ShiftRightAssign,
+                TokenKind::None, TokenKind::ShiftLeft, TokenKind::None, TokenKind::GreaterEqual,
+                TokenKind::None, TokenKind::PlusPlus, TokenKind::Assign, TokenKind::Bang,
+                TokenKind::BangEqual, TokenKind::Semicolon
+            };
+            Assert::AreEqual(expected.size(), tokens.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                Assert::AreEqual(static_cast<int>(expected[i]), static_cast<int>(tokens[i].kind));
+            }
+            Assert::AreEqual(std::string("<<="), std::string(tokens[1].text()));
+            Assert::AreEqual(static_cast<int>(TokenType::Operator), static_cast<int>(tokens[1].type));
+            Assert::AreEqual(static_cast<int>(TokenType::Punctuation), static_cast<int>(tokens[13].type));
+        }
+
+        TEST_METHOD(EveryOperatorIsRecognized)
+        {
+            for (size_t i = 0; i < OperatorCount; ++i) {
+                auto tokens = tokenize(std::string(operatorSpellings[i]));
+                Assert::AreEqual(size_t(1), tokens.size());
+                Assert::IsTrue(tokenKindText(tokens[0].kind) == operatorSpellings[i]);
+            }
+        }
+
+
+        TEST_METHOD(TryTokenizeReportsCodeAndOffset)
+        {
+            // Act
+            auto ok = tryTokenize("number x = 1;");
+            auto badChar = tryTokenize("x = 1 @ 2");
+            auto badFloat = tryTokenize("y = 12.;");
+            auto openString = tryTokenize("s = \"abc");
+
+            // Assert
+            Assert::IsTrue(static_cast<bool>(ok));
+            Assert::AreEqual(size_t(5), ok.value.size());
+            Assert::AreEqual(std::uint64_t(11), ok.value[3].offset);
+
+            Assert::IsFalse(static_cast<bool>(badChar));
+            Assert::IsTrue(badChar.error.code == ErrorCode::UnrecognizedCharacter);
+            Assert::AreEqual(std::uint64_t(6), badChar.error.offset);
+            Assert::IsTrue(badFloat.error.code == ErrorCode::InvalidFloat);
+            Assert::AreEqual(std::uint64_t(4), badFloat.error.offset);
+            Assert::IsTrue(openString.error.code == ErrorCode::UnterminatedString);
+            Assert::AreEqual(std::uint64_t(4), openString.error.offset);
+        }
+
+        TEST_METHOD(ThrowingTokenizeUsesErrorMessage)
+        {
+            for (const char* input : { "x = 1 @ 2", "y = 12.;", "s = \"abc", "/* open" }) {
+                Error error = tryTokenize(input).error;
+                try {
+                    tokenize(input);
+                    Assert::Fail(L"Expected a syntax error");
+                }
+                catch (const SyntaxError& e) {
+                    Assert::AreEqual(error.message(), std::string(e.what()));
+                    Assert::IsTrue(e.error().code == error.code);
+                }
+            }
+
+            Assert::AreEqual(std::string("Unrecognized character: '@'"), tryTokenize("@").error.message());
+        }
+
+        TEST_METHOD(InternedNamesShareOneId)
+        {
+            // Act
+            Symbol a = Symbol::intern("counter");
+            Symbol b = Symbol::intern(std::string("coun") + "ter");
+            Symbol c = Symbol::intern("Counter");
+
+            // Assert
+            Assert::IsTrue(a == b);
+            Assert::IsTrue(a != c);
+            Assert::AreEqual(std::string("counter"), std::string(a.text()));
+            Assert::AreEqual(std::string("Counter"), std::string(c.text()));
+            Assert::IsTrue(Symbol::intern("").empty());
+            Assert::AreEqual(std::uint32_t(0), Symbol().id());
+        }
+
+        TEST_METHOD(IdentifierTokensCarrySymbols)
+        {
+            // Act
+            auto tokens = tokenize("number total = total + 1;");
+
+            // Assert
+            Assert::IsTrue(tokens[1].symbol == Symbol::intern("total"));
+            Assert::IsTrue(tokens[1].symbol == tokens[3].symbol);
+            Assert::IsTrue(tokens[0].symbol.empty()); // keyword
+            Assert::IsTrue(tokens[5].symbol.empty()); // number
+
+            // Only the number keeps its own copy of the lexeme
+            Assert::IsTrue(tokens[1].literal.empty());
+            Assert::IsTrue(tokens[1].text().data() == tokens[3].text().data()); // the symbol's name
+            Assert::IsTrue(tokens[0].literal.empty() && tokens[2].literal.empty());
+            Assert::AreEqual(std::string("number total = total + 1 ;"),
+                std::string(tokens[0].text()) + " " + std::string(tokens[1].text()) + " " + std::string(tokens[2].text()) + " " +
+                std::string(tokens[3].text()) + " " + std::string(tokens[4].text()) + " " + std::string(tokens[5].text()) + " " +
+                std::string(tokens[6].text()));
+            Assert::AreEqual(std::string("1"), tokens[5].literal);
+        }
+
+        TEST_METHOD(SymbolTableGrowsAndInternsConcurrently)
+        {
+            // Arrange: enough names to grow the hash and add several segments
+            SymbolTable table;
+            std::vector<Symbol> first(5000), second(5000);
+            auto internAll = [&](std::vector<Symbol>& out) {
+                for (size_t i = 0; i < out.size(); ++i) {
+                    out[i] = table.intern("name" + std::to_string(i));
+                }
+            };
+
+            // Act
+            std::thread other([&] { internAll(second); });
+            internAll(first);
+            other.join();
+
+            // Assert
+            Assert::AreEqual(size_t(5001), table.size());
+            for (size_t i = 0; i < first.size(); ++i) {
+                Assert::IsTrue(first[i] == second[i]);
+                Assert::AreEqual("name" + std::to_string(i), std::string(table.text(first[i])));
+            }
+        }
+
+        TEST_METHOD(NumberTokensAreDecoded)
+        {
+            // Act
+            auto tokens = tokenize("7 2.5 9223372036854775807 0.0000000000000000000001");
+
+            // Assert
+            Assert::IsTrue(tokens[0].number.isInteger);
+            Assert::AreEqual(std::int64_t(7), tokens[0].number.integer);
+            Assert::IsFalse(tokens[1].number.isInteger);
+            Assert::AreEqual(2.5, tokens[1].number.real);
+            Assert::AreEqual(std::int64_t(9223372036854775807), tokens[2].number.integer);
+            Assert::AreEqual(1e-22, tokens[3].number.real);
+        }
+
+        TEST_METHOD(NumberOutOfRangeIsLexicalError)
+        {
+            // Act
+            auto tooBig = tryTokenize("x = 9223372036854775808;");
+            auto fits = tryTokenize("x = 0009223372036854775807;");
+
+            // Assert
+            Assert::IsTrue(tooBig.error.code == ErrorCode::NumberOutOfRange);
+            Assert::AreEqual(std::uint64_t(4), tooBig.error.offset);
+            Assert::AreEqual(std::string("Number out of range: '9223372036854775808'"), tooBig.error.message());
+            Assert::IsTrue(static_cast<bool>(fits));
+            Assert::AreEqual(std::int64_t(9223372036854775807), fits.value[2].number.integer);
+        }
+
+        TEST_METHOD(StringTokensAreDecoded)
+        {
+            // Act
+            auto tokens = tokenize(R"(s = "a\"b\\c\n"; t = ""; u = "plain"; v = "plain";)");
+
+            // Assert: text() keeps the spelling, decoded has the contents
+            Assert::AreEqual(std::string(R"("a\"b\\c\n")"), std::string(tokens[2].text()));
+            Assert::AreEqual(std::string("a\"b\\c\n"), std::string(tokens[2].decoded()));
+            Assert::IsTrue(tokens[2].decoded().data() == tokens[2].text().data() + tokens[2].text().size()); // in the same buffer
+            Assert::IsTrue(tokens[6].decoded().empty());
+            Assert::AreEqual(std::string("plain"), std::string(tokens[10].decoded()));
+            Assert::IsTrue(tokens[10].decoded().data() == tokens[10].text().data() + 1); // a slice of the spelling
+            Assert::IsTrue(tokens[0].decoded().empty());
+        }
+
+        TEST_METHOD(DecodeStringEscapes)
+        {
+            std::string out;
+            decodeString(R"("tab\there \q \0 \'")", out);
+            Assert::AreEqual(std::string("tab\there q ", 11) + std::string(1, '\0') + " '", out);
+        }
+
+        TEST_METHOD(CommentsGoToTrivia)
+        {
+            // Arrange
+            std::string input = "// header\nx = 1; /* why */ /* and how */ y = 2; // end";
+
+            // Act
+            std::vector<Trivia> trivia;
+            auto tokens = tokenize(input, trivia);
+
+            // Assert: the token stream is dense, comments are keyed by the token they precede
+            Assert::AreEqual(size_t(8), tokens.size());
+            Assert::AreEqual(size_t(4), trivia.size());
+            Assert::AreEqual(size_t(0), trivia[0].token);
+            Assert::AreEqual(std::string("// header"), std::string(trivia[0].text(input)));
+
+            auto beforeY = triviaBefore(trivia, 4);
+            Assert::AreEqual(2, static_cast<int>(beforeY.second - beforeY.first));
+            Assert::AreEqual(std::string("/* and how */"), std::string(beforeY.first[1].text(input)));
+            Assert::AreEqual(std::string("y"), std::string(tokens[4].text()));
+
+            Assert::AreEqual(tokens.size(), trivia[3].token); // trailing comment
+            Assert::IsTrue(triviaBefore(trivia, 1).first == triviaBefore(trivia, 1).second);
+            Assert::AreEqual(size_t(8), tokenize(input).size());
+        }
+
+
+        TEST_METHOD(ParallelTokenizeMatchesSequential)
+        {
+            // Arrange: tokens that span lines, so chunk cuts land inside them
+            std::string input;
+            for (int i = 0; i < 40; ++i) {
+                input += "x" + std::to_string(i) + " = \"a\nb\\\" c\" + 0x1F; /* one\n two // three\n */\n";
+                input += "// line " + std::to_string(i) + "\nif (x >= 10) { y -= 2.5; }\n\n";
+            }
+            std::vector<PackedToken> expected;
+            tokenizeInto(input, expected);
+
+            // Act & Assert
+            for (size_t threads : { 1, 3 }) {
+                ThreadPool pool(threads);
+                for (size_t chunkBytes : { 0, 1, 2, 5, 16, 100 }) {
+                    std::vector<PackedToken> tokens;
+                    tokenizeParallel(input, tokens, pool, chunkBytes);
+
+                    Assert::AreEqual(expected.size(), tokens.size());
+                    for (size_t i = 0; i < tokens.size(); ++i) {
+                        Assert::AreEqual(expected[i].offset, tokens[i].offset);
+                        Assert::AreEqual(expected[i].length, tokens[i].length);
+                        Assert::AreEqual(static_cast<int>(expected[i].kind), static_cast<int>(tokens[i].kind));
+                    }
+                }
+            }
+        }
+
+        TEST_METHOD(ParallelTokenizeReportsFirstError)
+        {
+            // Arrange: a '#' inside a comment is fine, the later one is not,
+            // and an unterminated string at the end hides nothing before it
+            std::string input = "a = 1;\n/* # \n # */ b = 2;\nc = #;\nd = \"open";
+            std::vector<PackedToken> expected;
+            Error expectedError;
+            Assert::IsFalse(tokenizeInto(input, expected, expectedError));
+
+            ThreadPool pool(2);
+
+            // Act & Assert
+            for (size_t chunkBytes = 1; chunkBytes < 12; ++chunkBytes) {
+                std::vector<PackedToken> tokens;
+                Error error;
+                Assert::IsFalse(tokenizeParallel(input, tokens, pool, error, chunkBytes));
+                Assert::AreEqual(static_cast<int>(expectedError.code), static_cast<int>(error.code));
+                Assert::AreEqual(expectedError.offset, error.offset);
+                Assert::AreEqual(expected.size(), tokens.size());
+            }
         }
     };
 }
\ No newline at end of file